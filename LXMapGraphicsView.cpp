@@ -12,9 +12,12 @@
 #include <QVBoxLayout>
 #include <QLabel>
 #include <QScreen>
+#include <QRubberBand>
 #include <QFileDialog>
-#include <QtConcurrent>
+#include "mapframescheduler.h"
 #include "mapoverlaywidget.h"
+#include "maptilemanager.h"
+#include "maptilelayeritem.h"
 
 LXMapGraphicsView::LXMapGraphicsView(QWidget* parent)
     : QGraphicsView(parent)
@@ -29,16 +32,20 @@ LXMapGraphicsView::LXMapGraphicsView(QWidget* parent)
     this->setResizeAnchor(QGraphicsView::NoAnchor);
     this->setSceneRect(m_scene->sceneRect());
 
-    connect(this, &LXMapGraphicsView::updateImage, this, &LXMapGraphicsView::drawImg);
+    m_tileManager = new MapTileManager(m_scene, this);
 
-    // 滚动时 overlay/信息框要跟着走
+    m_frameScheduler = new MapFrameScheduler(this);
+    connect(m_frameScheduler, &MapFrameScheduler::frame, this, &LXMapGraphicsView::runFrame);
+
+    // 滚动时 overlay 要立即跟上（viewport 滚动会连带移动子控件），
+    // 信息框和瓦片加载按帧合并：一次拖动会触发水平、垂直两个信号
     connect(horizontalScrollBar(), &QScrollBar::valueChanged, this, [this](){
         syncOverlayGeometry();
-        updateTargetInfoPanel();
+        scheduleFrame(MapFrameScheduler::InfoPanel | MapFrameScheduler::Tiles);
     });
     connect(verticalScrollBar(), &QScrollBar::valueChanged, this, [this](){
         syncOverlayGeometry();
-        updateTargetInfoPanel();
+        scheduleFrame(MapFrameScheduler::InfoPanel | MapFrameScheduler::Tiles);
     });
 }
 
@@ -67,40 +74,18 @@ void LXMapGraphicsView::setRect(QRect rect)
     recalcMinScale();
 }
 
-/**
- * @brief       绘制瓦片图
- * @param info
- */
-void LXMapGraphicsView::drawImg(const ImageInfo& info)
-{
-    constexpr int TILE_SIZE = 256;
-
-    // 1️⃣ 计算瓦片像素坐标
-    QPointF pos = Bing::tileXYToPixelXY(QPoint(info.x, info.y));
-
-    // 2️⃣ 绘制瓦片图像
-    QGraphicsPixmapItem* imgItem = m_scene->addPixmap(info.img);
-    imgItem->setPos(pos);
-    imgItem->setZValue(0);   // 底层
-
-    // 3️⃣ 绘制瓦片边框
-    QGraphicsRectItem* rectItem =
-        m_scene->addRect(QRectF(pos, QSizeF(TILE_SIZE, TILE_SIZE)));
-
-    QPen pen(QColor(255, 0, 0, 120));   // 半透明红色
-    pen.setWidth(1);
-    rectItem->setPen(pen);
-    rectItem->setBrush(Qt::NoBrush);
-    rectItem->setZValue(1);             // 在图片之上
-}
-
-
 /**
  * @brief 清空所有瓦片
  */
 void LXMapGraphicsView::clear()
 {
+    m_tileManager->clear();
+
+    // 底图图层由瓦片管理器持有，清空场景时保留
+    MapTileLayerItem* layer = m_tileManager->layerItem();
+    m_scene->removeItem(layer);
     m_scene->clear();
+    m_scene->addItem(layer);
 }
 
 
@@ -129,6 +114,7 @@ void LXMapGraphicsView::wheelEvent(QWheelEvent* event)
 
 	// 2️⃣ 记录缩放前鼠标 scene 坐标
 	QPointF scenePosBefore = mapToScene(viewPos);
+	m_tileManager->noteZoom(targetScale > currentScale, scenePosBefore);
 
 	// 3️⃣ 执行缩放
 	double factor = targetScale / currentScale;
@@ -140,7 +126,8 @@ void LXMapGraphicsView::wheelEvent(QWheelEvent* event)
 	translate(delta.x(), delta.y());
 
 	syncOverlayGeometry();
-	updateTargetInfoPanel();
+	updateZoomLevel();
+	scheduleFrame(MapFrameScheduler::InfoPanel | MapFrameScheduler::Tiles);
 
 	event->accept();
 }
@@ -157,12 +144,51 @@ void LXMapGraphicsView::getShowRect()
     rect.setBottomRight(this->mapToScene(this->width(), this->height()).toPoint());
 }
 
-void LXMapGraphicsView::setCenterLonLat(double lon, double lat)
+QRectF LXMapGraphicsView::visibleSceneRect() const
+{
+    return mapToScene(viewport()->rect()).boundingRect();
+}
+
+int LXMapGraphicsView::zoomLevel() const
 {
-    constexpr int zoom = 17;
+    return m_tileManager->level();
+}
+
+/**
+ * @brief 按当前缩放比选择瓦片级别：每缩小一半换低一级，保证每帧绘制的瓦片数大致不变
+ */
+void LXMapGraphicsView::updateZoomLevel()
+{
+    const QList<int> levels = m_tileManager->levels();
+    const double s = transform().m11();
+    if (levels.isEmpty() || s <= 0.0)
+        return;
+
+    // 理想级别：瓦片在屏幕上约 256 像素
+    const int ideal = m_sceneZoom + qRound(std::log2(s));
+
+    // 取最接近的已有级别，距离相同取更清晰的
+    int best = levels.first();
+    for (int z : levels)
+    {
+        if (qAbs(z - ideal) < qAbs(best - ideal) ||
+            (qAbs(z - ideal) == qAbs(best - ideal) && z > best))
+            best = z;
+    }
+
+    const int current = m_tileManager->level();
+    if (best == current)
+        return;
+
+    m_tileManager->setLevel(best);
+    emit zoom(best > current);
+}
 
+void LXMapGraphicsView::setCenterLonLat(double lon, double lat)
+{
     // 1️⃣ 经纬度 → 像素
-    centerPos  = Bing::latLongToPixelXY(lon, lat, zoom);
+    centerPos  = Bing::latLongToPixelXY(lon, lat, m_sceneZoom);
+    m_radarTransform = MapPolarTransform(lon, lat, m_sceneZoom, centerPos, m_radarTransformMode);
 
     centerOn(centerPos);
     getShowRect();
@@ -235,11 +261,9 @@ void LXMapGraphicsView::drawCenterCross(const QPointF& centerPixel,
                                       double armLengthMeters,
                                       double centerLatDeg)
 {
-    constexpr int ZOOM = 17;
-
     // 1️⃣ 米 → 像素
     double metersPerPixel =
-        Bing::groundResolution(centerLatDeg, ZOOM);
+        Bing::groundResolution(centerLatDeg, m_sceneZoom);
 
     double armPx = armLengthMeters / metersPerPixel;
 
@@ -279,17 +303,16 @@ void LXMapGraphicsView::setCenterScene(const QPointF& scenePos)
     translate(delta.x(), delta.y());
 
     getShowRect();
+    loadImages();
 }
 
 void LXMapGraphicsView::drawRadarCircle(const QPointF& centerPixel,
                                       double radiusMeters,
                                       double centerLatDeg)
 {
-    constexpr int ZOOM = 17;
-
     //使用你已有的 Bing 地面分辨率函数
     const double metersPerPixel =
-        Bing::groundResolution(centerLatDeg, ZOOM);
+        Bing::groundResolution(centerLatDeg, m_sceneZoom);
 
     const double radiusPx = radiusMeters / metersPerPixel;
 
@@ -316,29 +339,64 @@ void LXMapGraphicsView::drawRadarCircle(const QPointF& centerPixel,
 
 void LXMapGraphicsView::drawRadarTarget(RadarTargetData target)
 {
+    drawRadarTargets(QVector<RadarTargetData>{ target });
+}
+
+/**
+ * @brief         批量更新目标（一次雷达扫描）
+ * @param targets 本次扫描的目标
+ */
+void LXMapGraphicsView::drawRadarTargets(const QVector<RadarTargetData>& targets)
+{
+    if (targets.isEmpty())
+        return;
+
     ensureOverlay();
 
-    // 1) 缓存最新数据
-    m_radarNewTargets[target.targetId] = target;
+    // 1) 整批计算 scene 位置
+    const int count = targets.size();
+    QVector<QPointF> scenePos(count);
+    if (m_radarTransform.isValid())
+    {
+        QVector<double> az(count), range(count);
+        for (int i = 0; i < count; ++i)
+        {
+            az[i]    = targets[i].azimuthDeg;
+            range[i] = targets[i].rangeMeters;
+        }
+        m_radarTransform.toScene(az.constData(), range.constData(), count, scenePos.data());
+    }
+    else
+    {
+        for (int i = 0; i < count; ++i)
+            scenePos[i] = calcTargetScenePos(targets[i]);
+    }
 
-    // 2) 计算 scene 坐标（像素）
-    QPointF scenePos = calcTargetScenePos(target);
-    m_targetScenePos[target.targetId] = scenePos;
+    // 2) 写入目标存储，逐个通知 overlay（最新点 + 航迹点），脏区域累积到下一帧统一重绘
+    int selected = -1;
+    QVector<int> indices;
+    indices.reserve(count);
+    for (int i = 0; i < count; ++i)
+    {
+        const RadarTargetData& target = targets[i];
+        const int index = m_targets.upsert(target, scenePos[i]);
+        m_overlay->updateTarget(index);
+        indices.append(index);
 
-    // 3) 喂给 overlay（最新点 + 航迹点）
-    m_overlay->setTargets(m_radarNewTargets);
-    m_overlay->setTargetScenePos(target.targetId, scenePos);
-    m_overlay->appendTrackPoint(target.targetId, scenePos);   // ✅ 新增：航迹点入队
+        if (target.targetId == m_selectedTargetId)
+            selected = index;
+    }
     m_overlay->setSelectedTarget(m_selectedTargetId);
 
-    // 4) 如果是当前选中目标，发引导 & 更新信息框
-    if (m_selectedTargetId == target.targetId)
+    // 3) 当前选中目标在本批中：发引导 & 更新信息框（每批一次）
+    if (selected >= 0)
     {
-        emit sgnTargetGuide(target.azimuthDeg, target.elevationDeg);
-        updateTargetInfoPanel();
+        emit sgnTargetGuide(m_targets.azimuthDeg(selected), m_targets.elevationDeg(selected));
+        scheduleFrame(MapFrameScheduler::InfoPanel);
     }
 
-    m_overlay->checkAlertZones(target.targetId, scenePos);
+    // 4) 警戒区（整批判断）
+    m_overlay->checkAlertZones(indices);
 }
 
 
@@ -352,6 +410,15 @@ void LXMapGraphicsView::mousePressEvent(QMouseEvent* event)
         m_pressPos    = event->pos();
         m_lastPos     = event->pos();
 
+        // Ctrl + 左键：框选
+        if (event->modifiers() & Qt::ControlModifier)
+        {
+            if (!m_rubberBand)
+                m_rubberBand = new QRubberBand(QRubberBand::Rectangle, viewport());
+            m_rubberBand->setGeometry(QRect(m_pressPos, QSize()));
+            m_rubberBand->show();
+            m_rubberBand->raise();
+        }
     }
 
     QGraphicsView::mousePressEvent(event);
@@ -359,7 +426,11 @@ void LXMapGraphicsView::mousePressEvent(QMouseEvent* event)
 
 void LXMapGraphicsView::mouseMoveEvent(QMouseEvent* event)
 {
-    if (m_leftPressed)
+    if (m_leftPressed && m_rubberBand && m_rubberBand->isVisible())
+    {
+        m_rubberBand->setGeometry(QRect(m_pressPos, event->pos()).normalized());
+    }
+    else if (m_leftPressed)
     {
         if (!m_isDragging)
         {
@@ -386,6 +457,27 @@ void LXMapGraphicsView::mouseMoveEvent(QMouseEvent* event)
 
 void LXMapGraphicsView::mouseReleaseEvent(QMouseEvent* event)
 {
+    if (event->button() == Qt::LeftButton && m_rubberBand && m_rubberBand->isVisible())
+    {
+        // 框选：网格索引查询框内目标
+        m_rubberBand->hide();
+        m_leftPressed = false;
+
+        const QRectF sceneRect = mapToScene(QRect(m_pressPos, event->pos()).normalized()).boundingRect();
+        QVector<int> indices;
+        m_targets.query(sceneRect, indices);
+
+        QVector<int> ids;
+        ids.reserve(indices.size());
+        for (int index : qAsConst(indices))
+            ids.append(m_targets.id(index));
+        setSelectedTargets(ids);
+        emit sgnTargetsSelected(ids);
+
+        QGraphicsView::mouseReleaseEvent(event);
+        return;
+    }
+
     bool click = (event->button() == Qt::LeftButton) &&
                  ((event->pos() - m_pressPos).manhattanLength() < DRAG_THRESHOLD);
 
@@ -395,19 +487,9 @@ void LXMapGraphicsView::mouseReleaseEvent(QMouseEvent* event)
 
     if (click)
     {
-        int hitId = -1;
-        double bestDist = 1e18;
-
-        for (auto it = m_targetScenePos.begin(); it != m_targetScenePos.end(); ++it)
-        {
-            QPoint p = mapFromScene(it.value());
-            double d = QLineF(p, event->pos()).length();
-            if (d < PICK_RADIUS && d < bestDist)
-            {
-                bestDist = d;
-                hitId = it.key();
-            }
-        }
+        // 网格索引查找点击半径内最近的目标（半径换算到 scene 单位）
+        const int hit = m_targets.nearest(mapToScene(event->pos()), PICK_RADIUS / transform().m11());
+        const int hitId = hit >= 0 ? m_targets.id(hit) : -1;
 
         m_selectedTargetId = hitId;   // -1 表示取消选中
         if (m_overlay) m_overlay->setSelectedTarget(m_selectedTargetId);
@@ -463,38 +545,110 @@ QVector<int> LXMapGraphicsView::getFile(const QString& path)
 }
 
 /**
- * @brief 加载所有瓦片图
+ * @brief 按当前视口加载瓦片：只请求视口（含边距）内的瓦片，移除离开的瓦片
  */
 void LXMapGraphicsView::loadImages()
 {
-    QString root = "./map" + QString("/%1/").arg(17);
-    QString format = "jpg";
+    m_tileManager->updateViewport(visibleSceneRect());
+}
+
+void LXMapGraphicsView::setTileMargin(int tiles)
+{
+    m_tileManager->setMargin(tiles);
+    loadImages();
+}
 
-    m_imageInfos.clear();
-    ImageInfo info;
-    info.z = 17;
-    for (auto& tile : m_tiles)
+int LXMapGraphicsView::tileMargin() const
+{
+    return m_tileManager->margin();
+}
+
+void LXMapGraphicsView::setTileBorderVisible(bool visible)
+{
+    m_tileManager->layerItem()->setShowTileBorders(visible);
+}
+
+void LXMapGraphicsView::setTileCacheBudget(qint64 decodedBytes, qint64 compressedBytes)
+{
+    m_tileManager->cache().setBudget(decodedBytes, compressedBytes);
+}
+
+MapTileCacheStats LXMapGraphicsView::tileCacheStats() const
+{
+    return m_tileManager->cache().stats();
+}
+
+void LXMapGraphicsView::setTilePrefetchLookahead(int ms)
+{
+    m_tileManager->setPrefetchLookahead(ms);
+}
+
+MapPrefetchStats LXMapGraphicsView::tilePrefetchStats() const
+{
+    return m_tileManager->prefetchStats();
+}
+
+QVector<int> LXMapGraphicsView::selectedTargets() const
+{
+    QVector<int> ids;
+    for (int i = 0; i < m_targets.size(); ++i)
     {
-        QString path = root + QString("%1/%2.%3").arg(tile.x()).arg(tile.y()).arg(format);
-        info.url = path;
-        info.x = tile.x();
-        info.y = tile.y();
-        m_imageInfos.append(info);
+        if (m_targets.testFlag(i, MapTargetStore::Selected))
+            ids.append(m_targets.id(i));
     }
+    return ids;
+}
 
-    m_future = QtConcurrent::map(m_imageInfos, [this](ImageInfo& info) {
-        QPixmap pix;
-        if (pix.load(info.url))
-        {
-            info.img = pix;
+/**
+ * @brief     设置框选结果（替换之前的框选），只重绘选中状态变化的目标
+ * @param ids 目标 ID
+ */
+void LXMapGraphicsView::setSelectedTargets(const QVector<int>& ids)
+{
+    QVector<bool> selected(m_targets.size(), false);
+    for (int id : ids)
+    {
+        const int index = m_targets.indexOf(id);
+        if (index >= 0)
+            selected[index] = true;
+    }
 
-            // 回到主线程再更新 UI
-            QMetaObject::invokeMethod(this, [this, info]() {
-                emit updateImage(info);
-            }, Qt::QueuedConnection);
+    QVector<int> changed;
+    for (int i = 0; i < m_targets.size(); ++i)
+    {
+        if (m_targets.testFlag(i, MapTargetStore::Selected) != selected[i])
+        {
+            m_targets.setFlag(i, MapTargetStore::Selected, selected[i]);
+            changed.append(i);
         }
-    });
+    }
+
+    if (m_overlay && !changed.isEmpty())
+        m_overlay->selectionChanged(changed);
+}
+
+void LXMapGraphicsView::setMaxFrameRate(int hz)
+{
+    m_frameScheduler->setMaxFrameRate(hz);
+}
+
+void LXMapGraphicsView::scheduleFrame(int work)
+{
+    m_frameScheduler->request(work);
+}
 
+/**
+ * @brief      每帧最多执行一次：信息框定位、瓦片加载、覆盖层重绘
+ * @param work MapFrameScheduler::Work 组合
+ */
+void LXMapGraphicsView::runFrame(int work)
+{
+    if (work & MapFrameScheduler::Tiles)
+        loadImages();
+    if (work & MapFrameScheduler::InfoPanel)
+        updateTargetInfoPanel();
+    if ((work & MapFrameScheduler::Overlay) && m_overlay)
+        m_overlay->flushDirty();
 }
 
 void LXMapGraphicsView::ensureOverlay()
@@ -520,11 +674,57 @@ void LXMapGraphicsView::syncOverlayGeometry()
         m_targetInfoPanel->raise();
 }
 
-QPointF LXMapGraphicsView::calcTargetScenePos(const RadarTargetData& target) const
+/**
+ * @brief        批量经纬度转 scene 坐标（QPointF 的 x/y 在内存中交错存放，拆开后整批投影）
+ * @param lonLat 经纬度，x 为经度，y 为纬度
+ * @return       scene 坐标（m_sceneZoom 级别像素）
+ */
+QVector<QPointF> LXMapGraphicsView::lonLatToScene(const QVector<QPointF>& lonLat) const
+{
+    const int n = lonLat.size();
+    QVector<double> xs(n), ys(n);
+    for (int i = 0; i < n; ++i)
+    {
+        xs[i] = lonLat[i].x();
+        ys[i] = lonLat[i].y();
+    }
+    Bing::latLongToPixelXY(xs.constData(), ys.constData(), n, m_sceneZoom, xs.data(), ys.data());
+
+    QVector<QPointF> out(n);
+    for (int i = 0; i < n; ++i)
+        out[i] = QPointF(xs[i], ys[i]);
+    return out;
+}
+
+QVector<QPointF> LXMapGraphicsView::sceneToLonLat(const QVector<QPointF>& scenePts) const
 {
-    constexpr int ZOOM = 17;
+    const int n = scenePts.size();
+    QVector<double> xs(n), ys(n);
+    for (int i = 0; i < n; ++i)
+    {
+        xs[i] = scenePts[i].x();
+        ys[i] = scenePts[i].y();
+    }
+    Bing::pixelXYToLatLong(xs.constData(), ys.constData(), n, m_sceneZoom, xs.data(), ys.data());
+
+    QVector<QPointF> out(n);
+    for (int i = 0; i < n; ++i)
+        out[i] = QPointF(xs[i], ys[i]);
+    return out;
+}
 
-    double metersPerPixel = Bing::groundResolution(target.centerLatDeg, ZOOM);
+void LXMapGraphicsView::setRadarTransformMode(MapPolarTransform::Mode mode)
+{
+    m_radarTransformMode = mode;
+    // 未设置站址前只记录方式，setCenterLonLat 时生效
+    if (m_radarTransform.isValid())
+        m_radarTransform = MapPolarTransform(m_radarTransform.siteLon(), m_radarTransform.siteLat(),
+                                             m_sceneZoom, centerPos, mode);
+}
+
+QPointF LXMapGraphicsView::calcTargetScenePos(const RadarTargetData& target) const
+{
+    double metersPerPixel = Bing::groundResolution(target.centerLatDeg, m_sceneZoom);
     double rangePx = target.rangeMeters / metersPerPixel;
 
     double rad = qDegreesToRadians(target.azimuthDeg);
@@ -539,20 +739,15 @@ void LXMapGraphicsView::updateTargetInfoPanel()
     ensureOverlay();
 
     // 没选中就隐藏
-    if (m_selectedTargetId < 0 || !m_radarNewTargets.contains(m_selectedTargetId))
+    const int index = m_selectedTargetId < 0 ? -1 : m_targets.indexOf(m_selectedTargetId);
+    if (index < 0)
     {
         if (m_targetInfoPanel) m_targetInfoPanel->hide();
         return;
     }
 
     // 目标点 scene->view
-    if (!m_targetScenePos.contains(m_selectedTargetId))
-    {
-        if (m_targetInfoPanel) m_targetInfoPanel->hide();
-        return;
-    }
-
-    QPoint viewPos = mapFromScene(m_targetScenePos[m_selectedTargetId]);
+    QPoint viewPos = mapFromScene(m_targets.scenePos(index));
 
     // 视野外：隐藏（你之前提的“像航迹一样看不见”）
     if (!viewport()->rect().contains(viewPos))
@@ -607,7 +802,7 @@ void LXMapGraphicsView::updateTargetInfoPanel()
     }
 
     // 更新文本
-    const RadarTargetData& t = m_radarNewTargets[m_selectedTargetId];
+    const RadarTargetData t = m_targets.data(index);
 
     auto setTextByName = [&](const char* objName, const QString& txt){
         if (auto* lb = m_targetInfoPanel->findChild<QLabel*>(objName))
@@ -639,41 +834,31 @@ void LXMapGraphicsView::loadOfflineMap(
     double centerLat
     )
 {
-    // ---------- 1. 扫描瓦片 ----------
-    const QString levelPath =
-        mapRootPath + QString("/%1").arg(zoomLevel);
+    // ---------- 1. 瓦片目录（有瓦片包则优先用瓦片包，否则读持久化目录/扫描） ----------
+    const QString archivePath =
+        mapRootPath + "/" + MapTileArchive::defaultFileName();
 
-    QVector<int> tileXs = getDir(levelPath);
+    // scene 坐标固定为 zoomLevel 级像素，其他级别（map/16、map/15 ...）按缩放比切换
+    m_sceneZoom = zoomLevel;
+    m_tileManager->setSource(mapRootPath, zoomLevel);
 
-    m_tiles.clear();
-    for (int x : tileXs)
-    {
-        QString xPath = levelPath + QString("/%1").arg(x);
-        QVector<int> tileYs = getFile(xPath);
-        for (int y : tileYs)
-            m_tiles.append(QPoint(x, y));
-    }
+    MapTileCatalog& catalog = m_tileManager->catalog();
+    if (QFileInfo::exists(archivePath) && m_tileManager->openArchive(archivePath))
+        catalog.buildFromArchive(m_tileManager->archive());
+    else
+        catalog.loadOrScan(mapRootPath);
 
-    if (m_tiles.isEmpty())
+    if (!catalog.hasLevel(zoomLevel))
     {
-        qWarning() << "No tiles found in" << levelPath;
+        qWarning() << "No tiles found in" << mapRootPath + QString("/%1").arg(zoomLevel);
         return;
     }
 
-    // ---------- 2. 计算 sceneRect（⚠️ 用 min/max，别用 first/last） ----------
-    int minX = INT_MAX, minY = INT_MAX;
-    int maxX = INT_MIN, maxY = INT_MIN;
-
-    for (const QPoint& t : m_tiles)
-    {
-        minX = qMin(minX, t.x());
-        minY = qMin(minY, t.y());
-        maxX = qMax(maxX, t.x());
-        maxY = qMax(maxY, t.y());
-    }
+    // ---------- 2. 计算 sceneRect（瓦片编号包围范围） ----------
+    const QRect bounds = catalog.tileBounds(zoomLevel);
 
-    QPoint ltTile(minX, minY);
-    QPoint rdTile(maxX + 1, maxY + 1);   // +1 才包含完整瓦片
+    QPoint ltTile = bounds.topLeft();
+    QPoint rdTile = bounds.bottomRight() + QPoint(1, 1);   // +1 才包含完整瓦片
 
     QPoint ltPx = Bing::tileXYToPixelXY(ltTile);
     QPoint rdPx = Bing::tileXYToPixelXY(rdTile);
@@ -687,9 +872,6 @@ void LXMapGraphicsView::loadOfflineMap(
 
     setRect(sceneRect);
 
-    // ---------- 3. 加载瓦片 ----------
-    loadImages();   // 你已有逻辑，内部用 m_tiles + zoom
-
     // ---------- 4. 设置中心点 ----------
     setCenterLonLat(centerLon, centerLat);
 
@@ -700,6 +882,8 @@ void LXMapGraphicsView::loadOfflineMap(
     QTimer::singleShot(0, this, [this]() {
         centerOn(centerPos);
         syncOverlayGeometry();
+        updateZoomLevel();
+        loadImages();
         if (m_overlay) m_overlay->update();
     });
 }
@@ -736,4 +920,7 @@ void LXMapGraphicsView::resizeEvent(QResizeEvent* e)
         double factor = m_minScale / s;
         scale(factor, factor);
     }
+
+    updateZoomLevel();
+    loadImages();
 }
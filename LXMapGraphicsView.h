@@ -2,25 +2,17 @@
 #define MAPGRAPHICSVIEW_H
 #include "mapgraphicsview_global.h"
 #include "mapStruct.h"
+#include "maptilecache.h"
+#include "maptileprefetcher.h"
+#include "maptargetstore.h"
+#include "mappolartransform.h"
 #include <QGraphicsView>
 #include <QVector>
 #include <QMap>
-#include <QFuture>
 class MapOverlayWidget;
-struct RadarTargetData
-{
-    int targetId        = -1;    // 目标ID
-    double azimuthDeg   = 0.0;   // 方位角
-    double elevationDeg = 0.0;   // 俯仰角
-    double rangeMeters  = 0.0;   // 距离（米）
-    double centerLatDeg = 0.0;   // 中心点纬度（用于米→像素转换）
-
-    RadarTargetData() = default;
-
-    RadarTargetData(int id, double az, double el, double range, double lat)
-        : targetId(id), azimuthDeg(az), elevationDeg(el), rangeMeters(range), centerLatDeg(lat) {}
-};
-
+class MapTileManager;
+class MapFrameScheduler;
+class QRubberBand;
 class MAPGRAPHICSVIEW_EXPORT LXMapGraphicsView : public QGraphicsView
 {
     Q_OBJECT
@@ -29,15 +21,23 @@ public:
     ~LXMapGraphicsView() override;
 
     void setRect(QRect rect);
-    void drawImg(const ImageInfo& info);
     void clear();
 
     // 设置中心点（scene 像素坐标）
     void setCenterScene(const QPointF& scenePos);
 
-    // 设置中心点（经纬度，固定 17 级）
+    // 设置中心点（经纬度，scene 级别）
     void setCenterLonLat(double lon, double lat);
 
+    // 经纬度（x 经度，y 纬度）与 scene 坐标批量互转（如整层 GeoJSON、一次扫描的点迹）
+    QVector<QPointF> lonLatToScene(const QVector<QPointF>& lonLat) const;
+    QVector<QPointF> sceneToLonLat(const QVector<QPointF>& scenePts) const;
+
+    // scene 坐标所用级别（loadOfflineMap 传入的级别），目标/航迹/警戒区都以它为准
+    int sceneZoomLevel() const { return m_sceneZoom; }
+    // 当前显示的瓦片级别（随缩放在 map/16、map/15 ... 之间切换）
+    int zoomLevel() const;
+
     void drawRadarCircle(const QPointF& centerPixel, double radiusMeters, double centerLatDeg);
     void drawCenterCross(const QPointF& centerPixel, double armLengthMeters, double centerLatDeg);
 
@@ -48,21 +48,54 @@ public:
         double centerLat
         );
 
+    // 方位-距离 → scene 的变换方式（默认 LocalScale：站址纬度的单一比例；ExactMercator：球面 + 墨卡托）
+    void setRadarTransformMode(MapPolarTransform::Mode mode);
+    const MapPolarTransform& radarTransform() const { return m_radarTransform; }
+
     // 雷达目标显示（方位-距离）
     void drawRadarTarget(RadarTargetData traget);
+    // 一次雷达扫描的全部目标：位置、航迹、报警、选中状态统一更新，只触发一次重绘
+    void drawRadarTargets(const QVector<RadarTargetData>& targets);
+
+    // 框选（Ctrl + 左键拖动）选中的目标 ID
+    QVector<int> selectedTargets() const;
+    void setSelectedTargets(const QVector<int>& ids);
+
+    // 目标存储（视图持有，覆盖层只读引用）
+    const MapTargetStore& targetStore() const { return m_targets; }
+    MapTargetStore& targetStore() { return m_targets; }
     void recalcMinScale();
     QVector<int> getDir(const QString& path);
     QVector<int> getFile(const QString& path);
-    void loadImages();
+    void loadImages();   // 按当前视口加载瓦片（视口外的瓦片会被移除）
+
+    // 视口外额外加载的瓦片圈数
+    void setTileMargin(int tiles);
+    int tileMargin() const;
+
+    // 调试用：显示瓦片边框
+    void setTileBorderVisible(bool visible);
+
+    // 瓦片缓存预算（热层：解码图像；冷层：原始 JPEG 字节），单位字节
+    void setTileCacheBudget(qint64 decodedBytes, qint64 compressedBytes);
+    MapTileCacheStats tileCacheStats() const;   // 命中/未命中/淘汰计数
+
+    // 按平移速度预取的前瞻时间（毫秒，0 关闭），以及预取命中率
+    void setTilePrefetchLookahead(int ms);
+    MapPrefetchStats tilePrefetchStats() const;
+
+    // 信息框、瓦片加载、覆盖层重绘按帧合并执行，hz 为每秒最多执行次数（默认 60）
+    void setMaxFrameRate(int hz);
+    void scheduleFrame(int work);   // work 为 MapFrameScheduler::Work 组合
 
 
 signals:
-    void updateImage(const ImageInfo& info);   // 添加瓦片图
-    void zoom(bool flag);                      // 缩放 true：放大
+    void zoom(bool flag);   // 缩放 true：放大
     void showRect(QRect rect);
     void mousePos(QPoint pos);
 
     void sgnTargetGuide(double az,double pitch);
+    void sgnTargetsSelected(const QVector<int>& ids);   // 框选完成
 
 protected:
     void mouseMoveEvent(QMouseEvent* event) override;
@@ -73,6 +106,9 @@ protected:
 
 private:
     void getShowRect();   // 获取显示范围
+    void updateZoomLevel();   // 按当前缩放比选择瓦片级别，跨级时发出 zoom 信号
+    QRectF visibleSceneRect() const;   // 当前 viewport 对应的 scene 范围
+    void runFrame(int work);           // 执行本帧合并后的待办
 
 private:
     QGraphicsScene* m_scene = nullptr;
@@ -80,8 +116,11 @@ private:
     QPointF m_scenePos;
 
     QPointF centerPos;
+    int m_sceneZoom = 17;   // scene 像素 = 该级别像素
 
-    QMap<int, RadarTargetData> m_radarNewTargets;
+    MapTargetStore m_targets;   // 所有目标的最新数据（覆盖层直接读取）
+    MapPolarTransform m_radarTransform;   // 雷达站极坐标 → scene（setCenterLonLat 时创建）
+    MapPolarTransform::Mode m_radarTransformMode = MapPolarTransform::LocalScale;
 
 
 private:
@@ -103,10 +142,10 @@ private:
     bool   m_isDragging  = false;
     QPoint m_pressPos;           // view 坐标
     QPoint m_lastPos;
+    QRubberBand* m_rubberBand = nullptr;   // 框选框（Ctrl + 拖动时显示）
 
-    QList<QPoint> m_tiles;
-    QList<ImageInfo> m_imageInfos;   // 瓦片地图信息
-    QFuture<void> m_future;
+    MapTileManager* m_tileManager = nullptr;   // 视口驱动的瓦片加载
+    MapFrameScheduler* m_frameScheduler = nullptr;
 
     // private 区域新增：
 private:
@@ -118,9 +157,6 @@ private:
 private:
     MapOverlayWidget* m_overlay = nullptr;
 
-    // 最新目标点（scene 坐标），只保留“最新点”，不再往 scene 里 addEllipse
-    QMap<int, QPointF> m_targetScenePos;
-
 };
 
 #endif   // MAPGRAPHICSVIEW_H
@@ -0,0 +1,21 @@
+// 地图库性能基准（控制台程序，不属于地图库本身）
+#include "mapalertbenchmark.h"
+#include "maparchivecheck.h"
+#include "mappolarbenchmark.h"
+#include "mapprojectionbenchmark.h"
+#include <QCoreApplication>
+#include <QTextStream>
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QTextStream out(stdout);
+    out << MapAlertBenchmark::runSuite() << '\n';
+    out << MapProjectionBenchmark::run().summary() << '\n';
+    out << MapArchiveCheck::run().summary() << '\n';
+    out << MapArchiveCheck::runOverview().summary() << '\n';
+    out << MapPolarBenchmark::run(30.0, 17, 5000).summary() << '\n';
+    out << MapPolarBenchmark::run(60.0, 17, 5000).summary() << '\n';
+    return 0;
+}
@@ -0,0 +1,154 @@
+#include "mapalertbenchmark.h"
+
+#include "mapalertzoneindex.h"
+#include "mapzonekernel.h"
+#include <QElapsedTimer>
+#include <QLineF>
+#include <QPolygonF>
+#include <QRandomGenerator>
+#include <QStringList>
+#include <QVector>
+#include <QtMath>
+
+namespace {
+constexpr double WORLD_SIZE = 65536.0;   // 场景范围（约 17 级下 0.5° 的像素跨度）
+
+struct Circle
+{
+    QPointF center;
+    double radius;
+};
+}   // namespace
+
+QString MapAlertBenchmarkResult::summary() const
+{
+    return QString("alert zones: %1 circles + %2 polygons x %12 vertices, %3 targets x %4 rounds (%5)\n"
+                   "  legacy  %6 ms/scan\n"
+                   "  indexed %7 ms/scan (x%8)\n"
+                   "  batch   %9 ms/scan (x%10)\n"
+                   "  mismatches %11")
+        .arg(circles).arg(polygons).arg(targets).arg(rounds).arg(MapZoneKernel::isaName())
+        .arg(legacyMs, 0, 'f', 3)
+        .arg(indexedMs, 0, 'f', 3).arg(indexedMs > 0 ? legacyMs / indexedMs : 0.0, 0, 'f', 1)
+        .arg(batchMs, 0, 'f', 3).arg(batchMs > 0 ? legacyMs / batchMs : 0.0, 0, 'f', 1)
+        .arg(mismatches).arg(polygonVertices);
+}
+
+MapAlertBenchmarkResult MapAlertBenchmark::run(int circles, int polygons, int targets, int rounds, quint32 seed,
+                                               int polygonVertices)
+{
+    MapAlertBenchmarkResult result;
+    result.circles  = qMax(0, circles);
+    result.polygons = qMax(0, polygons);
+    result.targets  = qMax(1, targets);
+    result.rounds   = qMax(1, rounds);
+    result.polygonVertices = qMax(4, polygonVertices & ~1);   // 星形需要偶数个顶点
+
+    QRandomGenerator rng(seed);
+    auto uniform = [&rng](double lo, double hi) { return lo + rng.generateDouble() * (hi - lo); };
+
+    // 1) 警戒区
+    QVector<Circle> circleZones;
+    QVector<QPolygonF> polygonZones;
+    MapAlertZoneIndex index;
+    for (int i = 0; i < result.circles; ++i)
+    {
+        const Circle c{QPointF(uniform(0, WORLD_SIZE), uniform(0, WORLD_SIZE)), uniform(200, 2000)};
+        circleZones.append(c);
+        index.addCircle(c.center, c.radius);
+    }
+    for (int i = 0; i < result.polygons; ++i)
+    {
+        // 星形（凹）多边形：半径在内外两值间交替
+        const QPointF center(uniform(0, WORLD_SIZE), uniform(0, WORLD_SIZE));
+        const double outer = uniform(500, 3000), inner = outer * 0.45;
+        QVector<QPointF> pts;
+        for (int k = 0; k < result.polygonVertices; ++k)
+        {
+            const double a = k * 2.0 * M_PI / result.polygonVertices;
+            const double r = (k % 2) ? inner : outer;
+            pts.append(center + QPointF(r * qCos(a), r * qSin(a)));
+        }
+        polygonZones.append(QPolygonF(pts));
+        index.addPolygon(pts);
+    }
+
+    // 2) 每轮一批新目标
+    QVector<QVector<QPointF>> scans(result.rounds);
+    for (QVector<QPointF>& scan : scans)
+    {
+        scan.resize(result.targets);
+        for (QPointF& pt : scan)
+            pt = QPointF(uniform(0, WORLD_SIZE), uniform(0, WORLD_SIZE));
+    }
+
+    QVector<QVector<quint8>> legacy(result.rounds), indexed(result.rounds), batch(result.rounds);
+    QElapsedTimer timer;
+
+    // legacy：与改造前 checkAlertZones 相同的逐目标判断
+    timer.start();
+    for (int r = 0; r < result.rounds; ++r)
+    {
+        legacy[r].resize(result.targets);
+        for (int i = 0; i < result.targets; ++i)
+        {
+            const QPointF& pt = scans[r][i];
+            bool inAnyZone = false;
+            for (const Circle& c : qAsConst(circleZones))
+            {
+                if (QLineF(pt, c.center).length() <= c.radius)
+                {
+                    inAnyZone = true;
+                    break;
+                }
+            }
+            if (!inAnyZone)
+            {
+                for (const QPolygonF& poly : qAsConst(polygonZones))
+                {
+                    if (poly.containsPoint(pt, Qt::OddEvenFill))
+                    {
+                        inAnyZone = true;
+                        break;
+                    }
+                }
+            }
+            legacy[r][i] = inAnyZone ? 1 : 0;
+        }
+    }
+    result.legacyMs = timer.nsecsElapsed() / 1e6 / result.rounds;
+
+    timer.restart();
+    for (int r = 0; r < result.rounds; ++r)
+    {
+        indexed[r].resize(result.targets);
+        for (int i = 0; i < result.targets; ++i)
+            indexed[r][i] = index.contains(scans[r][i]) ? 1 : 0;
+    }
+    result.indexedMs = timer.nsecsElapsed() / 1e6 / result.rounds;
+
+    timer.restart();
+    for (int r = 0; r < result.rounds; ++r)
+        index.containsBatch(scans[r], batch[r]);
+    result.batchMs = timer.nsecsElapsed() / 1e6 / result.rounds;
+
+    // 3) 结果比对（边界上的点各方法可能有差异，随机点基本不会落在边上）
+    for (int r = 0; r < result.rounds; ++r)
+    {
+        for (int i = 0; i < result.targets; ++i)
+        {
+            if (legacy[r][i] != indexed[r][i] || legacy[r][i] != batch[r][i])
+                ++result.mismatches;
+        }
+    }
+    return result;
+}
+
+QString MapAlertBenchmark::runSuite(int targets, int rounds)
+{
+    QStringList lines;
+    lines << run(64, 64, targets, rounds).summary();
+    lines << run(256, 256, targets, rounds).summary();
+    lines << run(16, 32, targets, rounds, 1, 400).summary();   // 数百顶点：条带边表决定批量路径的代价
+    return lines.join('\n');
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <QString>
+
+// 警戒区判断的微基准：随机生成警戒区与一批目标点，比较
+//   legacy  —— 逐目标遍历所有区（QLineF::length / QPolygonF::containsPoint，旧实现）
+//   indexed —— 逐目标查网格索引（MapAlertZoneIndex::contains）
+//   batch   —— 整批调用 MapAlertZoneIndex::containsBatch（SIMD 内核）
+// 不编入地图库，由 benchmarks/main.cpp 的控制台程序调用（见 README）
+struct MapAlertBenchmarkResult
+{
+    int circles = 0;
+    int polygons = 0;
+    int polygonVertices = 0;
+    int targets = 0;
+    int rounds = 0;
+    double legacyMs  = 0.0;   // 每轮耗时（毫秒）
+    double indexedMs = 0.0;
+    double batchMs   = 0.0;
+    int mismatches = 0;       // 三种方法结果不一致的点数（应为 0）
+
+    QString summary() const;
+};
+
+class MapAlertBenchmark
+{
+public:
+    /**
+     * @param circles  圆形警戒区数量
+     * @param polygons 多边形警戒区数量（星形凹多边形）
+     * @param targets  每轮的目标数（一次扫描）
+     * @param rounds   轮数
+     * @param seed     随机种子
+     * @param polygonVertices 每个多边形的顶点数（航路走廊、禁飞区等可达数百）
+     */
+    static MapAlertBenchmarkResult run(int circles, int polygons, int targets,
+                                       int rounds = 20, quint32 seed = 1, int polygonVertices = 16);
+    // 固定的几组场景（少量小多边形 / 大量小多边形 / 数百顶点的大多边形），汇总输出
+    static QString runSuite(int targets = 5000, int rounds = 20);
+};
@@ -0,0 +1,177 @@
+#include "maparchivecheck.h"
+
+#include "maptilearchive.h"
+#include "maptilecatalog.h"
+#include "mapoverviewbuilder.h"
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QTemporaryDir>
+
+namespace {
+// 某列是否留空洞（让列内的 y 分成多个区间）
+bool isHole(int x, int y)
+{
+    return (x + 2 * y) % 7 == 0;
+}
+
+bool writeTile(const QString& root, int z, int x, int y)
+{
+    const QString dirPath = root + QString("/%1/%2").arg(z).arg(x);
+    QFile file(dirPath + QString("/%1.jpg").arg(y));
+    return QDir().mkpath(dirPath) && file.open(QIODevice::WriteOnly) &&
+           file.write(QByteArray("tile ") + QByteArray::number(x) + ',' + QByteArray::number(y)) > 0;
+}
+
+int countFiles(const QString& path)
+{
+    int n = 0;
+    QDirIterator it(path, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext())
+    {
+        it.next();
+        ++n;
+    }
+    return n;
+}
+}   // namespace
+
+QString MapArchiveCheckResult::summary() const
+{
+    if (!error.isEmpty())
+        return QString("tile archive: %1").arg(error);
+    return QString("tile archive: %1 tiles packed, missing %2, extra %3").arg(packed).arg(missing).arg(extra);
+}
+
+QString MapOverviewCheckResult::summary() const
+{
+    if (!error.isEmpty())
+        return QString("overview in archive: %1").arg(error);
+    return QString("overview in archive: generated %1, rebuilt %2, missing %3, loose files %4")
+        .arg(generated).arg(regenerated).arg(missing).arg(looseFiles);
+}
+
+MapArchiveCheckResult MapArchiveCheck::run()
+{
+    MapArchiveCheckResult result;
+
+    QTemporaryDir root;
+    if (!root.isValid())
+    {
+        result.error = "cannot create temporary directory";
+        return result;
+    }
+
+    // 1) 两个级别各一块 12×10 的区域，Z 序下同一列的瓦片不连续
+    struct Block { int z, x0, y0; };
+    const Block blocks[] = {{15, 26620, 12200}, {16, 53241, 24403}};
+    for (const Block& b : blocks)
+    {
+        for (int x = b.x0; x < b.x0 + 12; ++x)
+        {
+            for (int y = b.y0; y < b.y0 + 10; ++y)
+            {
+                if (isHole(x, y))
+                    continue;
+                if (!writeTile(root.path(), b.z, x, y))
+                {
+                    result.error = "cannot write tiles under " + root.path();
+                    return result;
+                }
+                ++result.packed;
+            }
+        }
+    }
+
+    // 2) 打包并从包索引构建目录
+    const QString archivePath = root.path() + "/" + MapTileArchive::defaultFileName();
+    if (!MapTileArchive::pack(root.path(), archivePath, &result.error))
+        return result;
+
+    MapTileArchive archive;
+    if (!archive.open(archivePath))
+    {
+        result.error = "cannot open " + archivePath;
+        return result;
+    }
+
+    MapTileCatalog catalog;
+    catalog.buildFromArchive(archive);
+
+    // 3) 区域外扩一圈逐块比对
+    for (const Block& b : blocks)
+    {
+        for (int x = b.x0 - 1; x <= b.x0 + 12; ++x)
+        {
+            for (int y = b.y0 - 1; y <= b.y0 + 10; ++y)
+            {
+                const bool expected = x >= b.x0 && x < b.x0 + 12 && y >= b.y0 && y < b.y0 + 10 && !isHole(x, y);
+                const bool found = catalog.contains(b.z, x, y);
+                if (expected && !found)
+                    ++result.missing;
+                else if (!expected && found)
+                    ++result.extra;
+            }
+        }
+    }
+    return result;
+}
+
+MapOverviewCheckResult MapArchiveCheck::runOverview()
+{
+    MapOverviewCheckResult result;
+
+    QTemporaryDir root;
+    if (!root.isValid())
+    {
+        result.error = "cannot create temporary directory";
+        return result;
+    }
+
+    // 1) 只含 17 级的瓦片包（内容不是有效 JPEG，降采样时按缺失子瓦片留白）
+    const int x0 = 106482, y0 = 48806;
+    for (int x = x0; x < x0 + 8; ++x)
+    {
+        for (int y = y0; y < y0 + 8; ++y)
+        {
+            if (!writeTile(root.path(), 17, x, y))
+            {
+                result.error = "cannot write tiles under " + root.path();
+                return result;
+            }
+        }
+    }
+
+    const QString archivePath = root.path() + "/" + MapTileArchive::defaultFileName();
+    if (!MapTileArchive::pack(root.path(), archivePath, &result.error))
+        return result;
+    QDir(root.path() + "/17").removeRecursively();
+
+    // 2) 生成 16 级，应合并进包且不留中间文件
+    result.generated = MapOverviewBuilder::build(root.path(), 17, 16, &result.error);
+    if (result.generated < 0)
+        return result;
+
+    MapTileArchive archive;
+    if (!archive.open(archivePath))
+    {
+        result.error = "cannot open " + archivePath;
+        return result;
+    }
+    MapTileCatalog catalog;
+    catalog.buildFromArchive(archive);
+    for (int x = x0 / 2; x < (x0 + 8) / 2; ++x)
+    {
+        for (int y = y0 / 2; y < (y0 + 8) / 2; ++y)
+        {
+            if (!catalog.contains(16, x, y))
+                ++result.missing;
+        }
+    }
+    archive.close();
+
+    // 3) 包中已有 16 级：不应重新生成
+    result.regenerated = MapOverviewBuilder::build(root.path(), 17, 16, &result.error);
+    result.looseFiles = countFiles(root.path() + "/16");
+    return result;
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <QString>
+
+// 瓦片包自检：在临时目录生成 mapRoot/z/x/y.jpg（两个级别、列内有空洞），打包后
+//   missing —— 目录中有、但瓦片包目录（buildFromArchive）查不到的瓦片数（应为 0）
+//   extra   —— 目录中没有、却被报告为存在的瓦片数（应为 0）
+// 不编入地图库，由 benchmarks/main.cpp 的控制台程序调用（见 README）
+struct MapArchiveCheckResult
+{
+    int packed = 0;   // 打包的瓦片数
+    int missing = 0;
+    int extra = 0;
+    QString error;    // 准备或打包失败的原因（为空表示成功）
+
+    QString summary() const;
+};
+
+// 瓦片包模式下的概览生成自检：瓦片包中只有 17 级（8×8）时生成 16 级，再对已含 16 级的包重跑一次
+//   generated / regenerated —— 两次 build 的返回值（应为 16 和 0）
+//   missing    —— 生成后瓦片包中查不到的 16 级瓦片数（应为 0）
+//   looseFiles —— 两次 build 后 mapRoot/16 下残留的中间文件数（应为 0）
+struct MapOverviewCheckResult
+{
+    int generated = -1;
+    int regenerated = -1;
+    int missing = 0;
+    int looseFiles = 0;
+    QString error;
+
+    QString summary() const;
+};
+
+class MapArchiveCheck
+{
+public:
+    static MapArchiveCheckResult run();
+    static MapOverviewCheckResult runOverview();
+};
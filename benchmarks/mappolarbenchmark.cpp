@@ -0,0 +1,82 @@
+#include "mappolarbenchmark.h"
+
+#include "bingformula.h"
+#include "mappolartransform.h"
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QVector>
+#include <QtMath>
+#include <cmath>
+
+QString MapPolarBenchmarkResult::summary() const
+{
+    return QString("polar -> scene: %1 targets x %2 rounds\n"
+                   "  legacy %3 ms/scan\n"
+                   "  local  %4 ms/scan (x%5), max diff %6 px\n"
+                   "  exact  %7 ms/scan (x%8), max diff %9 px")
+        .arg(targets).arg(rounds)
+        .arg(legacyMs, 0, 'f', 3)
+        .arg(localMs, 0, 'f', 3).arg(localMs > 0 ? legacyMs / localMs : 0.0, 0, 'f', 1)
+        .arg(localMaxDiffPx, 0, 'g', 3)
+        .arg(exactMs, 0, 'f', 3).arg(exactMs > 0 ? legacyMs / exactMs : 0.0, 0, 'f', 1)
+        .arg(exactMaxDiffPx, 0, 'g', 3);
+}
+
+MapPolarBenchmarkResult MapPolarBenchmark::run(double siteLat, int sceneZoom, int targets,
+                                               double maxRangeM, int rounds, quint32 seed)
+{
+    MapPolarBenchmarkResult result;
+    result.targets = qMax(1, targets);
+    result.rounds  = qMax(1, rounds);
+
+    const double siteLon = 116.0;
+    const QPoint sitePixel = Bing::latLongToPixelXY(siteLon, siteLat, sceneZoom);
+    const QPointF origin(sitePixel);
+    const MapPolarTransform local(siteLon, siteLat, sceneZoom, origin, MapPolarTransform::LocalScale);
+    const MapPolarTransform exact(siteLon, siteLat, sceneZoom, origin, MapPolarTransform::ExactMercator);
+
+    QRandomGenerator rng(seed);
+    const int n = result.targets;
+    QVector<double> az(n), range(n);
+    for (int i = 0; i < n; ++i)
+    {
+        az[i]    = rng.generateDouble() * 360.0;
+        range[i] = rng.generateDouble() * maxRangeM;
+    }
+
+    QVector<QPointF> legacy(n), batchLocal(n), batchExact(n);
+    QElapsedTimer timer;
+
+    // legacy：与改造前 calcTargetScenePos 相同的逐目标计算
+    timer.start();
+    for (int r = 0; r < result.rounds; ++r)
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            const double metersPerPixel = Bing::groundResolution(siteLat, sceneZoom);
+            const double rangePx = range[i] / metersPerPixel;
+            const double rad = qDegreesToRadians(az[i]);
+            legacy[i] = QPointF(origin.x() + rangePx * std::sin(rad), origin.y() - rangePx * std::cos(rad));
+        }
+    }
+    result.legacyMs = timer.nsecsElapsed() / 1e6 / result.rounds;
+
+    timer.restart();
+    for (int r = 0; r < result.rounds; ++r)
+        local.toScene(az.constData(), range.constData(), n, batchLocal.data());
+    result.localMs = timer.nsecsElapsed() / 1e6 / result.rounds;
+
+    timer.restart();
+    for (int r = 0; r < result.rounds; ++r)
+        exact.toScene(az.constData(), range.constData(), n, batchExact.data());
+    result.exactMs = timer.nsecsElapsed() / 1e6 / result.rounds;
+
+    for (int i = 0; i < n; ++i)
+    {
+        const QPointF dl = batchLocal[i] - legacy[i];
+        const QPointF de = batchExact[i] - legacy[i];
+        result.localMaxDiffPx = qMax(result.localMaxDiffPx, std::hypot(dl.x(), dl.y()));
+        result.exactMaxDiffPx = qMax(result.exactMaxDiffPx, std::hypot(de.x(), de.y()));
+    }
+    return result;
+}
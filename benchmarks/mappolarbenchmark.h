@@ -0,0 +1,35 @@
+#pragma once
+#include <QString>
+
+// 极坐标 → scene 变换的微基准：随机生成一批（方位、距离），比较
+//   legacy —— 逐目标计算（每次 groundResolution + sin/cos，原 calcTargetScenePos）
+//   local  —— MapPolarTransform::LocalScale 整批转换
+//   exact  —— MapPolarTransform::ExactMercator 整批转换
+// 不编入地图库，由 benchmarks/main.cpp 的控制台程序调用（见 README）
+struct MapPolarBenchmarkResult
+{
+    int targets = 0;
+    int rounds = 0;
+    double legacyMs = 0.0;   // 每轮耗时（毫秒）
+    double localMs  = 0.0;
+    double exactMs  = 0.0;
+    double localMaxDiffPx = 0.0;   // local 与 legacy 的最大差（像素，应为舍入误差量级）
+    double exactMaxDiffPx = 0.0;   // exact 与 legacy 的最大差（像素，即单一纬度近似的误差）
+
+    QString summary() const;
+};
+
+class MapPolarBenchmark
+{
+public:
+    /**
+     * @param siteLat     站址纬度
+     * @param sceneZoom   scene 级别
+     * @param targets     每轮的目标数（一次扫描）
+     * @param maxRangeM   最大距离（米）
+     * @param rounds      轮数
+     * @param seed        随机种子
+     */
+    static MapPolarBenchmarkResult run(double siteLat, int sceneZoom, int targets,
+                                       double maxRangeM = 50000.0, int rounds = 20, quint32 seed = 1);
+};
@@ -0,0 +1,100 @@
+#include "mapprojectionbenchmark.h"
+
+#include "bingformula.h"
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QVector>
+#include <cmath>
+
+QString MapProjectionBenchmarkResult::summary() const
+{
+    return QString("bing projection: %1 points x levels 1-23\n"
+                   "  mismatches %2, max round trip %3 deg, max pixel diff %4\n"
+                   "  level %5, %6 points: scalar %7 ms, batch %8 ms (x%9)\n"
+                   "  inverse: scalar %10 ms, batch %11 ms (x%12)")
+        .arg(pointsPerLevel).arg(mismatches).arg(maxRoundTripDeg, 0, 'g', 3).arg(maxPixelDiff, 0, 'g', 3)
+        .arg(timedLevel).arg(timedPoints)
+        .arg(scalarMs, 0, 'f', 3).arg(batchMs, 0, 'f', 3)
+        .arg(batchMs > 0 ? scalarMs / batchMs : 0.0, 0, 'f', 1)
+        .arg(scalarInverseMs, 0, 'f', 3).arg(batchInverseMs, 0, 'f', 3)
+        .arg(batchInverseMs > 0 ? scalarInverseMs / batchInverseMs : 0.0, 0, 'f', 1);
+}
+
+MapProjectionBenchmarkResult MapProjectionBenchmark::run(int pointsPerLevel, int timedLevel, int timedPoints,
+                                                         quint32 seed)
+{
+    MapProjectionBenchmarkResult result;
+    result.pointsPerLevel = qMax(4, pointsPerLevel);
+    result.timedLevel     = qBound(1, timedLevel, 23);
+    result.timedPoints    = qMax(1, timedPoints);
+
+    QRandomGenerator rng(seed);
+    auto uniform = [&rng](double lo, double hi) { return lo + rng.generateDouble() * (hi - lo); };
+
+    // 1) 自检：超出范围的输入也要与逐点函数一致（都先裁剪）
+    const int n = result.pointsPerLevel;
+    QVector<double> lon(n), lat(n), px(n), py(n), lon2(n), lat2(n);
+    for (int level = 1; level <= 23; ++level)
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            lon[i] = uniform(-190.0, 190.0);
+            lat[i] = uniform(-89.0, 89.0);
+        }
+        lon[0] = 180.0;  lat[0] = -85.05112878;   // 边界：连续像素为 mapSize，逐点结果为 mapSize - 1
+        lon[1] = -180.0; lat[1] = 85.05112878;
+
+        Bing::latLongToPixelXY(lon.constData(), lat.constData(), n, level, px.data(), py.data());
+        Bing::pixelXYToLatLong(px.constData(), py.constData(), n, level, lon2.data(), lat2.data());
+
+        const double size = Bing::mapSize(level);
+        const double last = size - 1.0;
+        for (int i = 0; i < n; ++i)
+        {
+            const double sinLat = std::sin(Bing::clipLat(lat[i]) * M_PI / 180.0);
+            const double refY = size * 0.5 - std::log((1 + sinLat) / (1 - sinLat)) * size / (4 * M_PI);
+            const double refX = (Bing::clipLon(lon[i]) + 180.0) * size / 360.0;
+            const double dx = std::abs(px[i] - qBound(0.0, refX, size));
+            const double dy = std::abs(py[i] - qBound(0.0, refY, size));
+            result.maxPixelDiff = qMax(result.maxPixelDiff, qMax(dx, dy));
+
+            const QPoint scalar = Bing::latLongToPixelXY(lon[i], lat[i], level);
+            if (qMin(std::floor(px[i] + 0.5), last) != scalar.x() || qMin(std::floor(py[i] + 0.5), last) != scalar.y())
+                ++result.mismatches;
+
+            const double dLon = std::abs(lon2[i] - Bing::clipLon(lon[i]));
+            const double dLat = std::abs(lat2[i] - Bing::clipLat(lat[i]));
+            result.maxRoundTripDeg = qMax(result.maxRoundTripDeg, qMax(dLon, dLat));
+        }
+    }
+
+    // 2) 耗时
+    const int m = result.timedPoints;
+    lon.resize(m); lat.resize(m); px.resize(m); py.resize(m); lon2.resize(m); lat2.resize(m);
+    for (int i = 0; i < m; ++i)
+    {
+        lon[i] = uniform(-180.0, 180.0);
+        lat[i] = uniform(-85.0, 85.0);
+    }
+
+    QVector<QPoint> scalarOut(m);
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < m; ++i)
+        scalarOut[i] = Bing::latLongToPixelXY(lon[i], lat[i], result.timedLevel);
+    result.scalarMs = timer.nsecsElapsed() / 1e6;
+
+    timer.restart();
+    Bing::latLongToPixelXY(lon.constData(), lat.constData(), m, result.timedLevel, px.data(), py.data());
+    result.batchMs = timer.nsecsElapsed() / 1e6;
+
+    timer.restart();
+    for (int i = 0; i < m; ++i)
+        Bing::pixelXYToLatLong(scalarOut[i], result.timedLevel, lon2[i], lat2[i]);
+    result.scalarInverseMs = timer.nsecsElapsed() / 1e6;
+
+    timer.restart();
+    Bing::pixelXYToLatLong(px.constData(), py.constData(), m, result.timedLevel, lon2.data(), lat2.data());
+    result.batchInverseMs = timer.nsecsElapsed() / 1e6;
+    return result;
+}
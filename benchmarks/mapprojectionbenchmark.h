@@ -0,0 +1,32 @@
+#pragma once
+#include <QString>
+
+// Bing 批量投影的自检 + 微基准：每个级别随机生成经纬度（含经纬度边界点），
+//   mismatches —— 批量结果按 min(floor(x + 0.5), mapSize - 1) 取整后与 latLongToPixelXY 不一致的点数（应为 0）
+//   maxRoundTripDeg —— 批量正反变换后与（裁剪后的）输入的最大差（度）
+//   maxPixelDiff —— 批量结果（多项式 sin / ln）与按 std::sin / std::log 逐点计算的连续像素的最大差
+// 并在 scene 常用级别比较逐点调用与批量调用（正、反两个方向）的耗时
+// 不编入地图库，由 benchmarks/main.cpp 的控制台程序调用（见 README）
+struct MapProjectionBenchmarkResult
+{
+    int pointsPerLevel = 0;
+    int mismatches = 0;
+    double maxRoundTripDeg = 0.0;
+    double maxPixelDiff = 0.0;
+
+    int timedLevel = 0;
+    int timedPoints = 0;
+    double scalarMs = 0.0;   // 逐点 latLongToPixelXY
+    double batchMs  = 0.0;   // 批量 latLongToPixelXY
+    double scalarInverseMs = 0.0;   // 逐点 pixelXYToLatLong
+    double batchInverseMs  = 0.0;   // 批量 pixelXYToLatLong
+
+    QString summary() const;
+};
+
+class MapProjectionBenchmark
+{
+public:
+    static MapProjectionBenchmarkResult run(int pointsPerLevel = 5000, int timedLevel = 17,
+                                            int timedPoints = 100000, quint32 seed = 1);
+};
@@ -6,8 +6,15 @@
  * 说明：   适用于Bing瓦片地图的算法
  * ******************************************************************/
 #include "bingformula.h"
+#include "maptilekey.h"
 #include <qstring.h>
 #include <QtMath>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LX_HAVE_SSE2 1
+#endif
 
 static const qreal g_EarthRadius = 6'378'137;   // 赤道半径
 
@@ -121,6 +128,187 @@ void Bing::pixelXYToLatLong(QPoint pos, int level, qreal& lon, qreal& lat)
     lat = 90 - (360 * qAtan(qExp(-y * 2 * M_PI)) / M_PI);
 }
 
+namespace {
+constexpr double MAX_LAT = 85.05112878;
+
+#ifdef LX_HAVE_SSE2
+// 多项式 c[0] + c[S] x + c[2S] x^2 + ...（N 项 Horner，模板递归展开，不留循环）
+template <int N, int S>
+struct PolySse2
+{
+    static __m128d eval(__m128d x, const double* c)
+    {
+        return _mm_add_pd(_mm_mul_pd(PolySse2<N - 1, S>::eval(x, c + S), x), _mm_set1_pd(c[0]));
+    }
+};
+
+template <int S>
+struct PolySse2<1, S>
+{
+    static __m128d eval(__m128d, const double* c) { return _mm_set1_pd(c[0]); }
+};
+
+// 多项式 c[0] + c[1] x + ... + c[N-1] x^(N-1)：偶次项、奇次项两路 Horner 交错，依赖链减半
+template <int N>
+inline __m128d polySse2(__m128d x, const double* c)
+{
+    const __m128d x2 = _mm_mul_pd(x, x);
+    return _mm_add_pd(PolySse2<(N + 1) / 2, 2>::eval(x2, c),
+                      _mm_mul_pd(x, PolySse2<N / 2, 2>::eval(x2, c + 1)));
+}
+
+// sin(x)，|x| <= pi/2：奇次泰勒展开到 x^21（截断误差 < 1e-18，与 std::sin 相差不超过 2 ulp）
+inline __m128d sinSse2(__m128d x)
+{
+    static const double c[] = {-1.0 / 6, 1.0 / 120, -1.0 / 5040, 1.0 / 362880, -1.0 / 39916800,
+                               1.0 / 6227020800.0, -1.0 / 1307674368000.0, 1.0 / 355687428096000.0,
+                               -1.0 / 121645100408832000.0, 1.0 / 51090942171709440000.0};
+    const __m128d z = _mm_mul_pd(x, x);
+    return _mm_add_pd(x, _mm_mul_pd(_mm_mul_pd(x, z), polySse2<10>(z, c)));
+}
+
+// ln(x)，x 为正的规格化数：x = 2^e * m，m 在 [sqrt(1/2), sqrt(2)) 内，ln m = 2 atanh((m - 1) / (m + 1))
+inline __m128d logSse2(__m128d x)
+{
+    static const double c[] = {2.0, 2.0 / 3, 2.0 / 5, 2.0 / 7, 2.0 / 9, 2.0 / 11, 2.0 / 13,
+                               2.0 / 15, 2.0 / 17, 2.0 / 19, 2.0 / 21, 2.0 / 23};
+    const __m128i bits = _mm_castpd_si128(x);
+    __m128d m = _mm_castsi128_pd(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi64x(0x000FFFFFFFFFFFFFll)),
+                                              _mm_set1_epi64x(0x3FF0000000000000ll)));
+    // 带偏置的指数放进 2^52 的尾数，再减去 2^52 + 1023 即得 e
+    __m128d e = _mm_sub_pd(_mm_castsi128_pd(_mm_or_si128(_mm_srli_epi64(bits, 52),
+                                                         _mm_set1_epi64x(0x4330000000000000ll))),
+                           _mm_set1_pd(4503599627370496.0 + 1023.0));
+    const __m128d big = _mm_cmpgt_pd(m, _mm_set1_pd(M_SQRT2));
+    m = _mm_sub_pd(m, _mm_and_pd(big, _mm_mul_pd(m, _mm_set1_pd(0.5))));
+    e = _mm_add_pd(e, _mm_and_pd(big, _mm_set1_pd(1.0)));
+
+    const __m128d z = _mm_div_pd(_mm_sub_pd(m, _mm_set1_pd(1.0)), _mm_add_pd(m, _mm_set1_pd(1.0)));
+    const __m128d lnm = _mm_mul_pd(z, polySse2<12>(_mm_mul_pd(z, z), c));
+    // ln2 拆成高低两部分，e * ln2Hi 没有舍入
+    return _mm_add_pd(_mm_mul_pd(e, _mm_set1_pd(6.93147180369123816490e-01)),
+                      _mm_add_pd(_mm_mul_pd(e, _mm_set1_pd(1.90821492927058770002e-10)), lnm));
+}
+
+// exp(x)，|x| <= 2pi：x = k ln2 + r，|r| <= ln2 / 2，泰勒展开到 r^14，再乘 2^k（直接拼指数位）
+inline __m128d expSse2(__m128d x)
+{
+    static const double c[] = {1.0, 1.0, 1.0 / 2, 1.0 / 6, 1.0 / 24, 1.0 / 120, 1.0 / 720, 1.0 / 5040,
+                               1.0 / 40320, 1.0 / 362880, 1.0 / 3628800, 1.0 / 39916800,
+                               1.0 / 479001600, 1.0 / 6227020800.0, 1.0 / 87178291200.0};
+    const __m128d shifter = _mm_set1_pd(6755399441055744.0);   // 1.5 * 2^52：相加后尾数低位即取整结果
+    const __m128d kShifted = _mm_add_pd(_mm_mul_pd(x, _mm_set1_pd(M_LOG2E)), shifter);
+    const __m128d k = _mm_sub_pd(kShifted, shifter);
+    const __m128d r = _mm_sub_pd(_mm_sub_pd(x, _mm_mul_pd(k, _mm_set1_pd(6.93147180369123816490e-01))),
+                                 _mm_mul_pd(k, _mm_set1_pd(1.90821492927058770002e-10)));
+    const __m128i scale = _mm_slli_epi64(_mm_add_epi64(_mm_castpd_si128(kShifted), _mm_set1_epi64x(1023)), 52);
+    return _mm_mul_pd(polySse2<15>(r, c), _mm_castsi128_pd(scale));
+}
+
+// atan(x)，0 <= x <= 1：两次半角约化 atan(x) = 2 atan(x / (1 + sqrt(1 + x^2)))，|x| <= 0.2 后泰勒展开
+inline __m128d atanUnitSse2(__m128d x)
+{
+    static const double c[] = {1.0, -1.0 / 3, 1.0 / 5, -1.0 / 7, 1.0 / 9, -1.0 / 11, 1.0 / 13,
+                               -1.0 / 15, 1.0 / 17, -1.0 / 19, 1.0 / 21, -1.0 / 23, 1.0 / 25};
+    const __m128d one = _mm_set1_pd(1.0);
+    for (int i = 0; i < 2; ++i)
+        x = _mm_div_pd(x, _mm_add_pd(one, _mm_sqrt_pd(_mm_add_pd(one, _mm_mul_pd(x, x)))));
+    return _mm_mul_pd(_mm_set1_pd(4.0), _mm_mul_pd(x, polySse2<13>(_mm_mul_pd(x, x), c)));
+}
+#endif
+}   // namespace
+
+/**
+ * @brief        批量经纬度转像素（double）：
+ *               SSE2 每次处理 2 个点，sin / ln 用上面的多项式实现（不逐点调用 libm），余下的点逐点计算
+ * @param lon    经度数组
+ * @param lat    纬度数组
+ * @param count  点数
+ * @param level  地图级别 1-23
+ * @param pixelX 输出像素 X
+ * @param pixelY 输出像素 Y
+ */
+void Bing::latLongToPixelXY(const double* lon, const double* lat, int count, int level,
+                            double* pixelX, double* pixelY)
+{
+    const double size  = mapSize(level);
+    const double kx    = size / 360.0;
+    const double ky    = size / (4 * M_PI);
+    const double toRad = M_PI / 180.0;
+
+    // 每个点先读完输入再写输出，输入输出可为同一块内存
+    int i = 0;
+#ifdef LX_HAVE_SSE2
+    const __m128d vMinLon = _mm_set1_pd(-180.0), vMaxLon = _mm_set1_pd(180.0);
+    const __m128d vMinLat = _mm_set1_pd(-MAX_LAT), vMaxLat = _mm_set1_pd(MAX_LAT);
+    const __m128d vToRad = _mm_set1_pd(toRad), vOne = _mm_set1_pd(1.0);
+    const __m128d v180 = _mm_set1_pd(180.0), vKx = _mm_set1_pd(kx), vKy = _mm_set1_pd(ky);
+    const __m128d vHalf = _mm_set1_pd(size * 0.5);
+    const __m128d vZero = _mm_setzero_pd(), vSize = _mm_set1_pd(size);
+    for (; i + 2 <= count; i += 2)
+    {
+        __m128d x = _mm_min_pd(_mm_max_pd(_mm_loadu_pd(lon + i), vMinLon), vMaxLon);
+        const __m128d la = _mm_min_pd(_mm_max_pd(_mm_loadu_pd(lat + i), vMinLat), vMaxLat);
+        const __m128d sinLat = sinSse2(_mm_mul_pd(la, vToRad));
+        const __m128d merc = logSse2(_mm_div_pd(_mm_add_pd(vOne, sinLat), _mm_sub_pd(vOne, sinLat)));
+
+        x = _mm_mul_pd(_mm_add_pd(x, v180), vKx);
+        const __m128d y = _mm_sub_pd(vHalf, _mm_mul_pd(merc, vKy));
+        _mm_storeu_pd(pixelX + i, _mm_min_pd(_mm_max_pd(x, vZero), vSize));
+        _mm_storeu_pd(pixelY + i, _mm_min_pd(_mm_max_pd(y, vZero), vSize));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        const double sinLat = std::sin(clipLat(lat[i]) * toRad);
+        const double merc = std::log((1 + sinLat) / (1 - sinLat));
+        pixelX[i] = clip((clipLon(lon[i]) + 180) * kx, 0, size);
+        pixelY[i] = clip(size * 0.5 - merc * ky, 0, size);
+    }
+}
+
+/**
+ * @brief        批量像素（double）转经纬度：SSE2 每次处理 2 个点（exp / atan 用多项式实现），余下的点逐点计算
+ * @param pixelX 像素 X
+ * @param pixelY 像素 Y
+ * @param count  点数
+ * @param level  地图级别 1-23
+ * @param lon    输出经度
+ * @param lat    输出纬度
+ */
+void Bing::pixelXYToLatLong(const double* pixelX, const double* pixelY, int count, int level,
+                            double* lon, double* lat)
+{
+    const double size = mapSize(level);
+
+    int i = 0;
+#ifdef LX_HAVE_SSE2
+    const __m128d vZero = _mm_setzero_pd(), vSize = _mm_set1_pd(size);
+    const __m128d vHalf = _mm_set1_pd(0.5), vInv = _mm_set1_pd(1.0 / size), v360 = _mm_set1_pd(360.0);
+    const __m128d v90 = _mm_set1_pd(90.0), vToDeg = _mm_set1_pd(360.0 / M_PI);
+    const __m128d vMinus2Pi = _mm_set1_pd(-2 * M_PI), vSign = _mm_set1_pd(-0.0);
+    for (; i + 2 <= count; i += 2)
+    {
+        const __m128d x = _mm_min_pd(_mm_max_pd(_mm_loadu_pd(pixelX + i), vZero), vSize);
+        const __m128d y = _mm_min_pd(_mm_max_pd(_mm_loadu_pd(pixelY + i), vZero), vSize);
+        const __m128d yn = _mm_sub_pd(vHalf, _mm_mul_pd(y, vInv));
+
+        // lat = 90 - (360 / pi) atan(exp(-2pi yn))；yn < 0 时 atan 的参数大于 1，
+        // 利用 atan(t) + atan(1 / t) = pi / 2 改为对 |yn| 计算后取反，参数始终在 (0, 1] 内
+        const __m128d sign = _mm_and_pd(yn, vSign);
+        const __m128d a = atanUnitSse2(expSse2(_mm_mul_pd(_mm_andnot_pd(vSign, yn), vMinus2Pi)));
+        _mm_storeu_pd(lat + i, _mm_xor_pd(_mm_sub_pd(v90, _mm_mul_pd(vToDeg, a)), sign));
+        _mm_storeu_pd(lon + i, _mm_mul_pd(_mm_sub_pd(_mm_mul_pd(x, vInv), vHalf), v360));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        const double yn = 0.5 - clip(pixelY[i], 0, size) / size;
+        lon[i] = (clip(pixelX[i], 0, size) / size - 0.5) * 360;
+        lat[i] = 90 - 360 * std::atan(std::exp(-yn * 2 * M_PI)) / M_PI;
+    }
+}
+
 /**
  * @brief     像素坐标转瓦片编号
  * @param pos  像素坐标
@@ -173,29 +361,14 @@ QPointF Bing::tileXYToLatLong(QPoint tile, int level)
 }
 
 /**
- * @brief         瓦片编号转 bing请求的QuadKey
+ * @brief         瓦片编号转 bing请求的QuadKey（经 64 位 Morton 编码直接展开，见 maptilekey.h）
  * @param tile   瓦片编号
  * @param level  瓦片级别
  * @return
  */
 QString Bing::tileXYToQuadKey(QPoint tile, int level)
 {
-    QString key;
-    for (int i = level; i > 0; i--)
-    {
-        char digit = '0';
-        int mask = 1 << (i - 1);
-        if ((tile.x() & mask) != 0)
-        {
-            digit++;
-        }
-        if ((tile.y() & mask) != 0)
-        {
-            digit += 2;
-        }
-        key.append(digit);
-    }
-    return key;
+    return MapTileKey::toQuadKey(MapTileKey::encode(level, tile.x(), tile.y()));
 }
 
 /**
@@ -203,33 +376,18 @@ QString Bing::tileXYToQuadKey(QPoint tile, int level)
  * @param quadKey
  * @param tileX      返回瓦片X编号
  * @param tileY      返回瓦片Y编号
- * @param level      返回瓦片等级
+ * @param level      返回瓦片等级（QuadKey 非法时为 -1）
  */
 void Bing::quadKeyToTileXY(QString quadKey, int& tileX, int& tileY, int& level)
 {
-    tileX = 0;
-    tileY = 0;
-    level = quadKey.count();
-    QByteArray buf = quadKey.toUtf8();
-    for (int i = level; i > 0; i--)
+    const quint64 key = MapTileKey::fromQuadKey(quadKey);
+    if (key == MapTileKey::INVALID)
     {
-        int mask = 1 << (i - 1);
-        switch (buf.at(i - 1))
-        {
-        case '0':
-            break;
-        case '1':
-            tileX |= mask;
-            break;
-        case '2':
-            tileY |= mask;
-            break;
-        case '3':
-            tileX |= mask;
-            tileY |= mask;
-            break;
-        default:
-            break;
-        }
+        tileX = tileY = 0;
+        level = -1;
+        return;
     }
+    tileX = MapTileKey::tileX(key);
+    tileY = MapTileKey::tileY(key);
+    level = MapTileKey::level(key);
 }
@@ -15,6 +15,15 @@ qreal mapScale(qreal lat, int level, int screenDpi);   // 计算比例尺
 QPoint latLongToPixelXY(qreal lon, qreal lat, int level);               // 经纬度转像素 XY坐标
 void pixelXYToLatLong(QPoint pos, int level, qreal& lon, qreal& lat);   // 像素坐标转WGS-84墨卡托坐标
 
+// 批量转换（double 像素，不取整）：count 个点一次转换，输入输出数组可为同一块内存
+// 像素范围 [0, mapSize(level)]（连续坐标，经度 180 / 纬度 -85.05112878 处等于 mapSize）；
+// latLongToPixelXY 的结果 = min(floor(double 像素 + 0.5), mapSize - 1)；
+// 有 SSE2 时 sin / ln / exp / atan 为多项式实现，与 libm 逐点结果相差不超过 1e-5 像素（23 级、高纬度处最大）
+void latLongToPixelXY(const double* lon, const double* lat, int count, int level,
+                      double* pixelX, double* pixelY);
+void pixelXYToLatLong(const double* pixelX, const double* pixelY, int count, int level,
+                      double* lon, double* lat);
+
 QPoint pixelXYToTileXY(QPoint pos);    // 像素坐标转瓦片编号
 QPoint tileXYToPixelXY(QPoint tile);   // 瓦片编号转像素坐标
 
@@ -8,7 +8,8 @@
  * 说明：   包含程序中使用到的结构体
  * ******************************************************************/
 
-#include <QPixmap>
+#include "maptilekey.h"
+#include <QHash>
 #include <QPointF>
 #include <QString>
 
@@ -20,8 +21,45 @@ struct ImageInfo
     int z;
     QString url;       // 下载瓦片的地址
     QString format;    // 图片格式
-    QPixmap img;       // 保存下载后的瓦片
     short count = 0;   // 失败下载次数，初始为0，下载失败一次+1
 };
 
+// 瓦片键：级别 + 瓦片编号（用于瓦片缓存、瓦片管理器）
+struct TileKey
+{
+    int z = 0;
+    int x = 0;
+    int y = 0;
+
+    TileKey() = default;
+    TileKey(int zz, int xx, int yy) : z(zz), x(xx), y(yy) {}
+
+    // 64 位 Morton 编码（见 maptilekey.h），缓存、索引、瓦片包都以它为键
+    quint64 code() const { return MapTileKey::encode(z, x, y); }
+    static TileKey fromCode(quint64 code)
+    {
+        return TileKey(MapTileKey::level(code), MapTileKey::tileX(code), MapTileKey::tileY(code));
+    }
+};
+
+inline bool operator==(const TileKey& a, const TileKey& b)
+{
+    return a.z == b.z && a.x == b.x && a.y == b.y;
+}
+
+// 雷达目标（方位-距离）
+struct RadarTargetData
+{
+    int targetId        = -1;    // 目标ID
+    double azimuthDeg   = 0.0;   // 方位角
+    double elevationDeg = 0.0;   // 俯仰角
+    double rangeMeters  = 0.0;   // 距离（米）
+    double centerLatDeg = 0.0;   // 中心点纬度（用于米→像素转换）
+
+    RadarTargetData() = default;
+
+    RadarTargetData(int id, double az, double el, double range, double lat)
+        : targetId(id), azimuthDeg(az), elevationDeg(el), rangeMeters(range), centerLatDeg(lat) {}
+};
+
 #endif   // MAPSTRUCT_H
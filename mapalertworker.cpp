@@ -0,0 +1,147 @@
+#include "mapalertworker.h"
+
+MapAlertWorker::MapAlertWorker(QObject* parent)
+    : QObject(parent)
+    , m_zones(MapAlertZoneSnapshot(new MapAlertZoneIndex))
+{
+    m_pool.setMaxThreadCount(1);
+}
+
+MapAlertWorker::~MapAlertWorker()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_pending.clear();
+    }
+    m_pool.waitForDone();
+}
+
+void MapAlertWorker::setZones(const MapAlertZoneSnapshot& zones)
+{
+    QMutexLocker locker(&m_mutex);
+    m_zones = zones ? zones : MapAlertZoneSnapshot(new MapAlertZoneIndex);
+}
+
+void MapAlertWorker::resetState()
+{
+    QMutexLocker locker(&m_mutex);
+    ++m_generation;
+    m_pending.clear();
+    m_events.clear();
+}
+
+/**
+ * @brief         主线程提交一批位置：只做拷贝，没有任务在跑时才启动一次工作线程任务
+ * @param samples 本批目标位置
+ */
+void MapAlertWorker::submit(const QVector<MapAlertSample>& samples)
+{
+    if (samples.isEmpty())
+        return;
+
+    bool start = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_pending += samples;
+        start = !m_running;
+        m_running = true;
+    }
+
+    if (start)
+        m_pool.start([this] { run(); });
+}
+
+void MapAlertWorker::run()
+{
+    for (;;)
+    {
+        QVector<MapAlertSample> batch;
+        MapAlertZoneSnapshot zones;
+        quint64 generation = 0;
+        {
+            QMutexLocker locker(&m_mutex);
+            if (m_pending.isEmpty())
+            {
+                m_running = false;
+                return;
+            }
+            batch.swap(m_pending);
+            zones = m_zones;
+            generation = m_generation;
+        }
+
+        if (generation != m_stateGeneration)
+        {
+            m_inside.clear();
+            m_stateGeneration = generation;
+        }
+
+        // 整批判断（快照不可变，无需加锁）
+        m_points.resize(batch.size());
+        for (int i = 0; i < batch.size(); ++i)
+            m_points[i] = batch[i].scenePos;
+        zones->containsBatch(m_points, m_hits);
+
+        // 状态机：同一目标在一批中出现多次时按顺序处理
+        QVector<Event> events;
+        for (int i = 0; i < batch.size(); ++i)
+        {
+            const int id = batch[i].targetId;
+            if (m_hits[i])
+            {
+                if (!m_inside.contains(id))
+                {
+                    m_inside.insert(id);
+                    events.append({id, true});
+                }
+            }
+            else if (m_inside.remove(id))
+            {
+                events.append({id, false});
+            }
+        }
+
+        if (events.isEmpty())
+            continue;
+
+        bool wake = false;
+        {
+            QMutexLocker locker(&m_mutex);
+            if (generation != m_generation)
+                continue;   // 期间已重置，结果作废
+            if (m_eventGeneration != generation)
+            {
+                m_events.clear();
+                m_eventGeneration = generation;
+            }
+            wake = m_events.isEmpty();
+            m_events += events;
+        }
+
+        // 析构时会等待线程池，this 在此期间有效
+        if (wake)
+            QMetaObject::invokeMethod(this, &MapAlertWorker::drainEvents, Qt::QueuedConnection);
+    }
+}
+
+void MapAlertWorker::drainEvents()
+{
+    QVector<Event> events;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_eventGeneration != m_generation)
+        {
+            m_events.clear();
+            return;
+        }
+        events.swap(m_events);
+    }
+
+    for (const Event& e : qAsConst(events))
+    {
+        if (e.enter)
+            emit entered(e.targetId);
+        else
+            emit left(e.targetId);
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include "mapgraphicsview_global.h"
+#include "mapalertzoneindex.h"
+#include <QObject>
+#include <QMutex>
+#include <QPointF>
+#include <QSet>
+#include <QSharedPointer>
+#include <QThreadPool>
+#include <QVector>
+
+// 警戒区快照：创建后不再修改，编辑警戒区时复制一份改完再整体替换（写时复制）
+using MapAlertZoneSnapshot = QSharedPointer<const MapAlertZoneIndex>;
+
+struct MapAlertSample
+{
+    int targetId = -1;
+    QPointF scenePos;
+};
+
+// 警戒判断工作线程：
+//   主线程只把本批目标位置（id + scene 坐标）放入队列，耗时与警戒区数量无关；
+//   工作线程用当前警戒区快照整批判断，维护"在区内"状态，
+//   再把进入/离开事件成批送回主线程，按发生顺序以 entered / left 信号发出。
+class MAPGRAPHICSVIEW_EXPORT MapAlertWorker : public QObject
+{
+    Q_OBJECT
+public:
+    explicit MapAlertWorker(QObject* parent = nullptr);
+    ~MapAlertWorker() override;
+
+    // 替换警戒区快照（之后提交的位置使用新快照判断）
+    void setZones(const MapAlertZoneSnapshot& zones);
+    // 清空"在区内"状态，尚未送达的事件作废（清除警戒区时调用，不发离开事件）
+    void resetState();
+    // 提交一批目标位置（主线程调用，不阻塞）
+    void submit(const QVector<MapAlertSample>& samples);
+
+signals:
+    void entered(int targetId);
+    void left(int targetId);
+
+private:
+    struct Event
+    {
+        int targetId;
+        bool enter;
+    };
+
+    void run();            // 工作线程：处理队列直到为空
+    void drainEvents();    // 主线程：取走整批事件并发信号
+
+private:
+    QThreadPool m_pool;    // 单线程，保证各批次按提交顺序判断
+
+    QMutex m_mutex;        // 保护以下输入与事件
+    QVector<MapAlertSample> m_pending;
+    MapAlertZoneSnapshot m_zones;
+    quint64 m_generation = 0;
+    bool m_running = false;
+    QVector<Event> m_events;
+    quint64 m_eventGeneration = 0;   // m_events 所属的代
+
+    // 仅工作线程访问
+    QSet<int> m_inside;
+    quint64 m_stateGeneration = 0;
+    QVector<QPointF> m_points;
+    QVector<quint8> m_hits;
+};
@@ -0,0 +1,314 @@
+#include "mapalertzoneindex.h"
+
+#include <QPolygonF>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+constexpr qint64 MAX_ZONE_CELLS  = 256;   // 一个警戒区最多登记的格子数
+constexpr int    EDGES_PER_BAND  = 4;     // 多边形边表每条带的平均边数
+}
+
+MapAlertZoneIndex::MapAlertZoneIndex(double cellSize)
+    : m_cell(cellSize > 0.0 ? cellSize : 512.0)
+{
+}
+
+void MapAlertZoneIndex::clear()
+{
+    m_zones.clear();
+    m_cells.clear();
+    m_largeZones.clear();
+}
+
+qint64 MapAlertZoneIndex::cellCoord(double v) const
+{
+    return qint64(std::floor(v / m_cell));
+}
+
+int MapAlertZoneIndex::addCircle(const QPointF& center, double radius)
+{
+    Zone zone;
+    zone.circle  = true;
+    zone.center  = center;
+    zone.radius2 = radius * radius;
+    zone.bounds  = QRectF(center.x() - radius, center.y() - radius, radius * 2, radius * 2);
+    return insert(std::move(zone));
+}
+
+/**
+ * @brief        添加多边形：边按所跨的水平条带分桶（一条边可能进入多个条带）
+ * @param points 顶点（scene 坐标，首尾不必重复）
+ * @return       警戒区编号
+ */
+int MapAlertZoneIndex::addPolygon(const QVector<QPointF>& points)
+{
+    if (points.size() < 3)
+        return -1;
+
+    Zone zone;
+    zone.bounds = QPolygonF(points).boundingRect();
+
+    QVector<Edge> edges;
+    edges.reserve(points.size());
+    for (int i = 0; i < points.size(); ++i)
+    {
+        QPointF a = points[i];
+        QPointF b = points[(i + 1) % points.size()];
+        if (a.y() == b.y())
+            continue;   // 水平边对射线法没有贡献
+        if (a.y() > b.y())
+            std::swap(a, b);
+
+        Edge e;
+        e.y0   = a.y();
+        e.y1   = b.y();
+        e.x0   = a.x();
+        e.dxdy = (b.x() - a.x()) / (b.y() - a.y());
+        edges.append(e);
+    }
+
+    const int bands = qMax(1, edges.size() / EDGES_PER_BAND);
+    zone.bandHeight = qMax(zone.bounds.height() / bands, 1e-9);
+
+    // 先计数再填充，得到紧凑的分桶数组
+    auto bandOf = [&](double y) {
+        return qBound(0, int((y - zone.bounds.top()) / zone.bandHeight), bands - 1);
+    };
+    zone.bandStart.fill(0, bands + 1);
+    for (const Edge& e : qAsConst(edges))
+    {
+        for (int b = bandOf(e.y0); b <= bandOf(e.y1); ++b)
+            ++zone.bandStart[b + 1];
+    }
+    for (int b = 0; b < bands; ++b)
+        zone.bandStart[b + 1] += zone.bandStart[b];
+
+    zone.bandEdges.resize(zone.bandStart[bands]);
+    QVector<int> fill = zone.bandStart;
+    for (const Edge& e : qAsConst(edges))
+    {
+        for (int b = bandOf(e.y0); b <= bandOf(e.y1); ++b)
+            zone.bandEdges[fill[b]++] = e;
+    }
+
+    return insert(std::move(zone));
+}
+
+/**
+ * @brief      登记到网格（覆盖格子太多的放入大区列表）
+ */
+int MapAlertZoneIndex::insert(Zone&& zone)
+{
+    const int id = m_zones.size();
+    const QRectF bounds = zone.bounds;
+    m_zones.append(std::move(zone));
+
+    const qint64 x0 = cellCoord(bounds.left()), x1 = cellCoord(bounds.right());
+    const qint64 y0 = cellCoord(bounds.top()),  y1 = cellCoord(bounds.bottom());
+    if ((x1 - x0 + 1) * (y1 - y0 + 1) > MAX_ZONE_CELLS)
+    {
+        m_largeZones.append(id);
+        return id;
+    }
+
+    for (qint64 cx = x0; cx <= x1; ++cx)
+    {
+        for (qint64 cy = y0; cy <= y1; ++cy)
+            m_cells[packCell(cx, cy)].append(id);
+    }
+    return id;
+}
+
+bool MapAlertZoneIndex::zoneContains(const Zone& zone, const QPointF& pt) const
+{
+    if (!zone.bounds.contains(pt))
+        return false;
+
+    if (zone.circle)
+    {
+        const QPointF d = pt - zone.center;
+        return d.x() * d.x() + d.y() * d.y() <= zone.radius2;
+    }
+
+    // 射线法（奇偶规则）：只检查所在条带的边；边跨多个条带时每条带各存一份，不会重复计数
+    const int bands = zone.bandStart.size() - 1;
+    const int b = qBound(0, int((pt.y() - zone.bounds.top()) / zone.bandHeight), bands - 1);
+
+    bool inside = false;
+    for (int i = zone.bandStart[b]; i < zone.bandStart[b + 1]; ++i)
+    {
+        const Edge& e = zone.bandEdges[i];
+        if (pt.y() >= e.y0 && pt.y() < e.y1 && pt.x() < e.x0 + (pt.y() - e.y0) * e.dxdy)
+            inside = !inside;
+    }
+    return inside;
+}
+
+int MapAlertZoneIndex::zoneAt(const QPointF& pt) const
+{
+    int best = -1;
+
+    auto cell = m_cells.constFind(packCell(cellCoord(pt.x()), cellCoord(pt.y())));
+    if (cell != m_cells.cend())
+    {
+        for (int id : cell.value())
+        {
+            if ((best < 0 || id < best) && zoneContains(m_zones[id], pt))
+                best = id;
+        }
+    }
+
+    for (int id : m_largeZones)
+    {
+        if ((best < 0 || id < best) && zoneContains(m_zones[id], pt))
+            best = id;
+    }
+    return best;
+}
+
+bool MapAlertZoneIndex::contains(const QPointF& pt) const
+{
+    auto cell = m_cells.constFind(packCell(cellCoord(pt.x()), cellCoord(pt.y())));
+    if (cell != m_cells.cend())
+    {
+        for (int id : cell.value())
+        {
+            if (zoneContains(m_zones[id], pt))
+                return true;
+        }
+    }
+
+    for (int id : m_largeZones)
+    {
+        if (zoneContains(m_zones[id], pt))
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief      点所在格子的候选警戒区 + 大区（不做精确判断）
+ */
+void MapAlertZoneIndex::candidateZones(const QPointF& pt, QVector<int>& out) const
+{
+    out.clear();
+    auto cell = m_cells.constFind(packCell(cellCoord(pt.x()), cellCoord(pt.y())));
+    if (cell != m_cells.cend())
+        out += cell.value();
+    out += m_largeZones;
+}
+
+/**
+ * @brief        批量判断一批点是否落在任一警戒区内
+ *               1) 每个点经网格取候选区，包围矩形命中的点下标记入该区的桶；
+ *               2) 每个非空桶把点整理成 x/y 连续数组，圆做距离平方；多边形按条带分组，
+ *                  每组只沿本条带的边做射线法（SIMD），代价与逐点查询（contains）相同量级。
+ * @param points 点（scene 坐标）
+ * @param inside 输出，与 points 等长，1 表示在区内
+ */
+void MapAlertZoneIndex::containsBatch(const QVector<QPointF>& points, QVector<quint8>& inside) const
+{
+    const int n = points.size();
+    inside.fill(0, n);
+    if (n == 0 || m_zones.isEmpty())
+        return;
+
+    // 1) 分桶：zoneStart/zonePoints 为按区连续存放的点下标（先计数再填充）
+    QVector<int> zoneStart(m_zones.size() + 1, 0);
+    QVector<int> pairs;   // (区, 点) 对，顺序追加
+    pairs.reserve(n * 2);
+    QVector<int> candidates;
+    for (int i = 0; i < n; ++i)
+    {
+        candidateZones(points[i], candidates);
+        for (int id : qAsConst(candidates))
+        {
+            if (!m_zones[id].bounds.contains(points[i]))
+                continue;
+            pairs.append(id);
+            pairs.append(i);
+            ++zoneStart[id + 1];
+        }
+    }
+    if (pairs.isEmpty())
+        return;
+
+    for (int z = 0; z < m_zones.size(); ++z)
+        zoneStart[z + 1] += zoneStart[z];
+
+    QVector<int> zonePoints(pairs.size() / 2);
+    QVector<int> fill = zoneStart;
+    for (int k = 0; k < pairs.size(); k += 2)
+        zonePoints[fill[pairs[k]]++] = pairs[k + 1];
+
+    // 2) 每个区一次批量判断；多边形的候选点先按条带排好，每条带只对本条带的边调用内核
+    QVector<double> xs, ys;
+    QVector<quint8> hit;
+    QVector<int> order, bandOfPoint, bandFill;
+    for (int z = 0; z < m_zones.size(); ++z)
+    {
+        const int begin = zoneStart[z], count = zoneStart[z + 1] - begin;
+        if (count == 0)
+            continue;
+
+        const Zone& zone = m_zones[z];
+        const int* ids = zonePoints.constData() + begin;
+        xs.resize(count);
+        ys.resize(count);
+        hit.fill(0, count);
+
+        if (zone.circle)
+        {
+            for (int k = 0; k < count; ++k)
+            {
+                xs[k] = points[ids[k]].x();
+                ys[k] = points[ids[k]].y();
+            }
+            MapZoneKernel::circle(xs.constData(), ys.constData(), count,
+                                  zone.center.x(), zone.center.y(), zone.radius2, hit.data());
+            for (int k = 0; k < count; ++k)
+                inside[ids[k]] |= hit[k];
+            continue;
+        }
+
+        // 按条带计数排序：order[j] 为排序后第 j 个点在 ids 中的位置
+        const int bands = zone.bandStart.size() - 1;
+        bandOfPoint.resize(count);
+        bandFill.fill(0, bands + 1);
+        for (int k = 0; k < count; ++k)
+        {
+            const int b = qBound(0, int((points[ids[k]].y() - zone.bounds.top()) / zone.bandHeight), bands - 1);
+            bandOfPoint[k] = b;
+            ++bandFill[b + 1];
+        }
+        for (int b = 0; b < bands; ++b)
+            bandFill[b + 1] += bandFill[b];
+
+        const QVector<int> bandBegin = bandFill;
+        order.resize(count);
+        for (int k = 0; k < count; ++k)
+            order[bandFill[bandOfPoint[k]]++] = k;
+
+        for (int j = 0; j < count; ++j)
+        {
+            const QPointF& pt = points[ids[order[j]]];
+            xs[j] = pt.x();
+            ys[j] = pt.y();
+        }
+
+        for (int b = 0; b < bands; ++b)
+        {
+            const int first = bandBegin[b], n = bandBegin[b + 1] - first;
+            if (n == 0)
+                continue;
+            const int e0 = zone.bandStart[b];
+            MapZoneKernel::polygon(xs.constData() + first, ys.constData() + first, n,
+                                   zone.bandEdges.constData() + e0, zone.bandStart[b + 1] - e0,
+                                   hit.data() + first);
+        }
+
+        for (int j = 0; j < count; ++j)
+            inside[ids[order[j]]] |= hit[j];
+    }
+}
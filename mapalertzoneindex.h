@@ -0,0 +1,63 @@
+#pragma once
+#include "mapgraphicsview_global.h"
+#include "mapzonekernel.h"
+#include <QHash>
+#include <QPointF>
+#include <QRectF>
+#include <QVector>
+
+// 警戒区索引：
+//   各警戒区的包围矩形登记到 scene 均匀网格中，点查询只检查所在格子里的候选区；
+//   多边形预处理成按水平条带分桶的边表，射线法只需检查点所在条带内的边。
+//   覆盖格子过多的大区单独存放，查询时只做包围矩形判断后再精确判断。
+class MAPGRAPHICSVIEW_EXPORT MapAlertZoneIndex
+{
+public:
+    explicit MapAlertZoneIndex(double cellSize = 512.0);
+
+    int addCircle(const QPointF& center, double radius);
+    int addPolygon(const QVector<QPointF>& points);   // 少于 3 个点返回 -1
+    void clear();
+
+    int zoneCount() const { return m_zones.size(); }
+    bool isEmpty() const { return m_zones.isEmpty(); }
+
+    // 点是否落在任一警戒区内
+    bool contains(const QPointF& pt) const;
+    // 点所在的第一个警戒区编号（按添加顺序），不在任何区内返回 -1
+    int zoneAt(const QPointF& pt) const;
+    // 批量判断（一次扫描的全部目标）：inside[i] = points[i] 是否落在任一警戒区内；
+    // 先按网格把点分到候选警戒区，再对每个区的候选点调用 MapZoneKernel 的批量内核
+    void containsBatch(const QVector<QPointF>& points, QVector<quint8>& inside) const;
+
+private:
+    using Edge = MapZoneKernel::Edge;   // y0 < y1（水平边不入表）
+
+    struct Zone
+    {
+        bool circle = false;
+        QRectF bounds;
+        // 圆
+        QPointF center;
+        double radius2 = 0.0;
+        // 多边形：边表按条带分桶，bandEdges[bandStart[b] .. bandStart[b+1]) 为第 b 条带的边
+        double bandHeight = 0.0;
+        QVector<int> bandStart;
+        QVector<Edge> bandEdges;
+    };
+
+    int insert(Zone&& zone);
+    bool zoneContains(const Zone& zone, const QPointF& pt) const;
+    void candidateZones(const QPointF& pt, QVector<int>& out) const;
+    static quint64 packCell(qint64 cx, qint64 cy)
+    {
+        return (quint64(quint32(qint32(cx))) << 32) | quint32(qint32(cy));
+    }
+    qint64 cellCoord(double v) const;
+
+private:
+    double m_cell = 512.0;
+    QVector<Zone> m_zones;
+    QHash<quint64, QVector<int>> m_cells;   // 格子 → 与之相交的警戒区
+    QVector<int> m_largeZones;              // 覆盖格子过多、不登记到网格的警戒区
+};
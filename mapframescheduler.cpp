@@ -0,0 +1,47 @@
+#include "mapframescheduler.h"
+
+MapFrameScheduler::MapFrameScheduler(QObject* parent)
+    : QObject(parent)
+{
+    m_timer.setSingleShot(true);
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &MapFrameScheduler::runFrame);
+    m_clock.start();
+}
+
+void MapFrameScheduler::setMaxFrameRate(int hz)
+{
+    m_maxFrameRate = qBound(1, hz, 240);
+}
+
+/**
+ * @brief      登记待办：距上一帧已超过帧间隔时下一轮事件循环就执行，否则等到下一帧
+ * @param work Work 组合
+ */
+void MapFrameScheduler::request(int work)
+{
+    m_pending |= work;
+    if (m_timer.isActive())
+        return;
+
+    const qint64 interval = 1000 / m_maxFrameRate;
+    const qint64 elapsed  = m_lastFrameMs < 0 ? interval : m_clock.elapsed() - m_lastFrameMs;
+    m_timer.start(int(qMax<qint64>(0, interval - elapsed)));
+}
+
+void MapFrameScheduler::flush()
+{
+    m_timer.stop();
+    runFrame();
+}
+
+void MapFrameScheduler::runFrame()
+{
+    const int work = m_pending;
+    m_pending = 0;
+    if (work == 0)
+        return;
+
+    m_lastFrameMs = m_clock.elapsed();
+    emit frame(work);
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "mapgraphicsview_global.h"
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTimer>
+
+// 帧节拍合并器：各处只登记“需要做什么”，每个显示帧最多执行一次。
+//   空闲后的第一次请求立即在下一轮事件循环执行（拖动的输入延迟不增加），
+//   之后的请求按帧间隔合并，执行次数与目标更新频率无关。
+class MAPGRAPHICSVIEW_EXPORT MapFrameScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    enum Work
+    {
+        InfoPanel = 0x1,   // 信息框跟随选中目标
+        Tiles     = 0x2,   // 按视口加载瓦片
+        Overlay   = 0x4,   // 覆盖层重绘（累积的脏区域）
+    };
+
+    explicit MapFrameScheduler(QObject* parent = nullptr);
+
+    // 帧率上限（默认 60，常用 30/60）
+    void setMaxFrameRate(int hz);
+    int maxFrameRate() const { return m_maxFrameRate; }
+
+    // 登记待办，在本帧或下一帧统一执行
+    void request(int work);
+    // 立即执行所有待办（不等帧节拍）
+    void flush();
+
+signals:
+    void frame(int work);   // 本帧需要执行的待办（Work 组合）
+
+private:
+    void runFrame();
+
+private:
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+    qint64 m_lastFrameMs = -1;
+    int m_maxFrameRate = 60;
+    int m_pending = 0;
+};
@@ -2,12 +2,14 @@
 #include "LXMapGraphicsView.h"
 
 #include "bingformula.h"
+#include "mapframescheduler.h"
 #include <QMouseEvent>
 #include <QCoreApplication>
 
 MapOverlayWidget::MapOverlayWidget(LXMapGraphicsView* view)
     : QWidget(view ? view->viewport() : nullptr)
     , m_view(view)
+    , m_zones(new MapAlertZoneIndex)
 {
     // 覆盖层必须透明背景
     setAttribute(Qt::WA_TranslucentBackground, true);
@@ -16,6 +18,9 @@ MapOverlayWidget::MapOverlayWidget(LXMapGraphicsView* view)
 
     initAlertButtons();   // 加这一行
 
+    connect(&m_alertWorker, &MapAlertWorker::entered, this, &MapOverlayWidget::onAlertEntered);
+    connect(&m_alertWorker, &MapAlertWorker::left, this, &MapOverlayWidget::onAlertLeft);
+
     // 始终盖在 viewport 上
     raise();
     show();
@@ -76,49 +81,168 @@ void MapOverlayWidget::initAlertButtons()
 
 void MapOverlayWidget::appendTrackPoint(int id, const QPointF& scenePos)
 {
-    auto& vec = m_tracks[id];
+    const int index = m_view ? m_view->targetStore().indexOf(id) : -1;
+    if (index >= 0)
+        appendTrackPointAt(index, scenePos);
+}
+
+void MapOverlayWidget::setMaxTrackPoints(int points)
+{
+    m_tracks.setCapacity(qBound(2, points, MAX_TRACK_POINTS));
+    m_trackLod.clear();   // 航迹池已重排，简化缓存重建
+    update();
+}
+
+/**
+ * @brief          追加航迹点（航迹号 = 目标存储下标）
+ * @param index    目标下标
+ * @param scenePos scene 坐标
+ */
+void MapOverlayWidget::appendTrackPointAt(int index, const QPointF& scenePos)
+{
+    const int n = m_tracks.size(index);
 
     // 去抖：如果点几乎没动，就不重复塞（避免线段抖成一团）
-    if (!vec.isEmpty())
+    if (n > 0 && QLineF(m_tracks.last(index), scenePos).length() < 1.0)  // 1px 阈值，可调
+        return;
+
+    // 新增的线段
+    QPolygonF dirtyScene;
+    if (n > 0)
+        dirtyScene << m_tracks.last(index);
+    dirtyScene << scenePos;
+
+    // 限长：环形缓冲区满时覆盖最旧点，被移除的旧线段也要擦掉
+    QPointF removed;
+    if (m_tracks.append(index, scenePos, &removed))
+        dirtyScene << removed << m_tracks.first(index);
+
+    markDirty(sceneToViewRect(dirtyScene.boundingRect(), TRACK_DIRTY_MARGIN));
+}
+
+/**
+ * @brief       目标已写入视图的目标存储：重绘新旧位置，追加航迹点
+ * @param index 目标在存储中的下标
+ */
+void MapOverlayWidget::updateTarget(int index)
+{
+    if (!m_view)
+        return;
+
+    const MapTargetStore& store = m_view->targetStore();
+    const QPointF& pos = store.scenePos(index);
+    if (store.testFlag(index, MapTargetStore::HasPrevPos))
     {
-        const QPointF& last = vec.last();
-        if (QLineF(last, scenePos).length() < 1.0)  // 1px 阈值，可调
+        const QPointF& prev = store.prevScenePos(index);
+        if (prev == pos)
             return;
+        markDirty(markerViewRect(prev));
     }
+    markDirty(markerViewRect(pos));
 
-    vec.push_back(scenePos);
+    appendTrackPointAt(index, pos);
+}
 
-    // 限长
-    if (vec.size() > m_maxTrackPoints)
-        vec.erase(vec.begin(), vec.begin() + (vec.size() - m_maxTrackPoints));
+void MapOverlayWidget::setSelectedTarget(int id)
+{
+    if (id == m_selectedId)
+        return;
 
-    update();
+    // 新旧选中目标的圆点和整条航迹都要换颜色
+    const int oldId = m_selectedId;
+    m_selectedId = id;
+    markDirty(targetViewRect(oldId));
+    markDirty(targetViewRect(id));
 }
 
-void MapOverlayWidget::setTargets(const QMap<int, RadarTargetData>& targets)
+void MapOverlayWidget::selectionChanged(const QVector<int>& changedIndices)
 {
-    m_targets = targets;
-    update();
+    if (!m_view)
+        return;
+
+    const MapTargetStore& store = m_view->targetStore();
+    for (int index : changedIndices)
+        markDirty(targetViewRect(store.id(index)));
 }
 
-void MapOverlayWidget::setTargetScenePos(int targetId, const QPointF& scenePos)
+void MapOverlayWidget::markDirty(const QRect& viewRect)
 {
-    m_targetScenePos[targetId] = scenePos;
-    update();
+    if (viewRect.isEmpty() || !viewRect.intersects(rect()))
+        return;   // 视野外的变化不需要重绘
+
+    m_dirtyRects.append(viewRect);
+    if (m_view)
+        m_view->scheduleFrame(MapFrameScheduler::Overlay);
+    else
+        flushDirty();
 }
 
-void MapOverlayWidget::setSelectedTarget(int id)
+/**
+ * @brief 提交累积的脏区域：矩形不多时逐个提交，
+ *        一批更新了大量目标时合并成一个包围矩形（区域求并本身也是 O(n²)）
+ */
+void MapOverlayWidget::flushDirty()
 {
-    m_selectedId = id;
-    update();
+    if (m_dirtyRects.isEmpty())
+        return;
+
+    if (m_dirtyRects.size() <= MAX_DIRTY_RECTS)
+    {
+        for (const QRect& r : qAsConst(m_dirtyRects))
+            update(r);
+    }
+    else
+    {
+        QRect bounds;
+        for (const QRect& r : qAsConst(m_dirtyRects))
+            bounds |= r;
+        update(bounds & rect());
+    }
+    m_dirtyRects.clear();
+}
+
+/**
+ * @brief           scene 范围转 view 范围（外扩 margin 个像素，覆盖线宽和抗锯齿）
+ * @param sceneRect scene 坐标范围
+ * @param margin    外扩像素
+ */
+QRect MapOverlayWidget::sceneToViewRect(const QRectF& sceneRect, int margin) const
+{
+    if (!m_view)
+        return QRect();
+
+    const QRect r = m_view->mapFromScene(sceneRect).boundingRect();
+    return r.adjusted(-margin, -margin, margin, margin);
+}
+
+QRect MapOverlayWidget::markerViewRect(const QPointF& scenePos) const
+{
+    return sceneToViewRect(QRectF(scenePos, QSizeF()), MARKER_DIRTY_MARGIN);
+}
+
+/**
+ * @brief    目标圆点与整条航迹的 view 范围（选中状态变化时使用）
+ * @param id 目标 ID（-1 返回空）
+ */
+QRect MapOverlayWidget::targetViewRect(int id) const
+{
+    QRect r;
+    const int index = m_view ? m_view->targetStore().indexOf(id) : -1;
+    if (index >= 0)
+        r |= markerViewRect(m_view->targetStore().scenePos(index));
+
+    if (index >= 0 && m_tracks.size(index) > 0)
+        r |= sceneToViewRect(m_tracks.bounds(index), TRACK_DIRTY_MARGIN);
+    return r;
 }
 
 QPoint MapOverlayWidget::viewPosOf(int targetId) const
 {
-    if (!m_view || !m_targetScenePos.contains(targetId))
+    const int index = m_view ? m_view->targetStore().indexOf(targetId) : -1;
+    if (index < 0)
         return QPoint(-999999, -999999);
 
-    return m_view->mapFromScene(m_targetScenePos.value(targetId));
+    return m_view->mapFromScene(m_view->targetStore().scenePos(index));
 }
 
 bool MapOverlayWidget::isTargetInView(int targetId) const
@@ -129,153 +253,21 @@ bool MapOverlayWidget::isTargetInView(int targetId) const
 
 void MapOverlayWidget::paintEvent(QPaintEvent* e)
 {
-    Q_UNUSED(e)
-
     if (!m_view)
         return;
 
+    // 只有局部重绘时，跳过完全落在重绘区域外的航迹和圆点
+    const QRect dirty = e->rect();
+
     QPainter p(this);
     p.setRenderHint(QPainter::Antialiasing, true);
     p.setClipRect(rect());
 
-    // ========= 雷达HUD（统一虚线风格） =========
+    // ========= 雷达HUD（缓存图像，只在变换/尺寸/参数变化时重画） =========
     if (m_hasRadar)
     {
-        const QPointF centerView = m_view->mapFromScene(m_radarCenterScene);
-
-        // 米 -> scene像素
-        constexpr int ZOOM = 17;
-        const double metersPerPixel =
-            Bing::groundResolution(m_radarCenterLatDeg, ZOOM);
-
-        // scene像素 -> view像素
-        const double s = m_view->transform().m11();
-        auto metersToViewPx = [&](double meters) -> double {
-            return (meters / metersPerPixel) * s;
-        };
-
-        // ===== 雷达绿配色（只靠透明度区分） =====
-        const QColor greenMajor(0, 255, 120, 200);
-        const QColor greenMid  (0, 255, 120, 150);
-        const QColor greenMinor(0, 255, 120, 100);
-        const QColor greenFaint(0, 255, 120, 70);
-
-        p.setBrush(Qt::NoBrush);
-
-        // ===== 同心圆（全虚线）=====
-        for (double meters : m_ringMeters)
-        {
-            const double r = metersToViewPx(meters);
-            const bool isMajor =
-                (m_majorRingStepMeters > 0) &&
-                (qRound(meters) % m_majorRingStepMeters == 0);
-
-            QPen pen;
-            if (isMajor)
-            {
-                pen = QPen(greenMid, 1.8);
-                pen.setDashPattern({6, 6});
-            }
-            else
-            {
-                pen = QPen(greenMinor, 1.2);
-                pen.setDashPattern({4, 6});
-            }
-
-            pen.setCapStyle(Qt::RoundCap);
-            p.setPen(pen);
-
-            QRectF rc(centerView.x() - r, centerView.y() - r, r * 2, r * 2);
-            p.drawEllipse(rc);
-        }
-
-        // ===== 主十字线（虚线，最强）=====
-        const double arm = metersToViewPx(m_crossArmMeters);
-        {
-            QPen pen(greenMajor, 2.4);
-            pen.setDashPattern({8, 6});
-            pen.setCapStyle(Qt::RoundCap);
-            p.setPen(pen);
-
-            p.drawLine(QPointF(centerView.x() - arm, centerView.y()),
-                       QPointF(centerView.x() + arm, centerView.y()));
-            p.drawLine(QPointF(centerView.x(), centerView.y() - arm),
-                       QPointF(centerView.x(), centerView.y() + arm));
-        }
-
-        // ===== 米字线（45°，虚线，中等）=====
-        {
-            QPen pen(greenMid, 1.6);
-            pen.setDashPattern({6, 6});
-            pen.setCapStyle(Qt::RoundCap);
-            p.setPen(pen);
-
-            const double d = arm / std::sqrt(2.0);
-
-            p.drawLine(QPointF(centerView.x() - d, centerView.y() - d),
-                       QPointF(centerView.x() + d, centerView.y() + d));
-            p.drawLine(QPointF(centerView.x() - d, centerView.y() + d),
-                       QPointF(centerView.x() + d, centerView.y() - d));
-        }
-
-        // ===== 中心弱点（可选）=====
-        {
-            p.setPen(Qt::NoPen);
-            p.setBrush(greenFaint);
-            p.drawEllipse(centerView, 3.0, 3.0);
-        }
-
-        // ===== 每个同心圆只显示一个距离值：统一在水平线右侧 =====
-        {
-            // 文本样式（清晰但不抢画面）
-            QFont f = p.font();
-            f.setPixelSize(13);
-            f.setBold(true);
-            p.setFont(f);
-
-            const QColor textColor(0, 255, 120, 200);
-            QPen textPen(textColor);
-            p.setPen(textPen);
-
-            QFontMetrics fm(p.font());
-
-            // 轻微背景块，让字在地图上更清晰（不想要可删掉背景那几行）
-            auto drawTag = [&](const QPointF& anchor, const QString& txt)
-            {
-                const int w = fm.horizontalAdvance(txt);
-                const int h = fm.height();
-
-                QRectF box(anchor.x(),
-                           anchor.y() - h + 4,
-                           w + 10,
-                           h + 6);
-
-                p.setPen(Qt::NoPen);
-                p.setBrush(QColor(0, 0, 0, 90));
-                p.drawRoundedRect(box, 6, 6);
-
-                p.setPen(textPen);
-                p.drawText(box.adjusted(6, 0, -4, 0),
-                           Qt::AlignVCenter | Qt::AlignLeft,
-                           txt);
-            };
-
-            // 逐圈标注：每个圈只标一个值（右侧）
-            for (int i = 0; i < m_ringMeters.size(); ++i)
-            {
-                const double meters = m_ringMeters[i];
-                const double r = metersToViewPx(meters);
-
-                // 文字内容
-                const QString txt = QString::number(int(qRound(meters))) + "m";
-
-                // 位置：水平线右侧，稍微上移避免压线
-                // 如果你觉得文字太靠近线，可以把 -16 改成 -20 或 -24
-                QPointF pos(centerView.x() + r + 8.0, centerView.y() - 16.0);
-
-                drawTag(pos, txt);
-            }
-        }
+        updateHudCache();
+        p.drawPixmap(0, 0, m_hudCache);
     }
 
     // ========= 警戒区（scene坐标 -> view坐标绘制） =========
@@ -336,21 +328,35 @@ void MapOverlayWidget::paintEvent(QPaintEvent* e)
     }
 
     // ========= 1) 画航迹折线 =========
-    for (auto it = m_tracks.begin(); it != m_tracks.end(); ++it)
+    const MapTargetStore& store = m_view->targetStore();
+    const double scale = m_view->transform().m11();
+    m_trackLod.setScale(scale);   // 缩小时按像素格抽稀
+
+    // 重绘区域对应的 scene 范围：先在 scene 中裁剪，不在范围内的不做坐标变换
+    const QRectF dirtyScene = m_view->mapToScene(dirty & rect()).boundingRect();
+    const double trackMargin = TRACK_DIRTY_MARGIN / scale;
+
+    QPolygon poly;   // 各航迹复用同一块缓冲
+    const int slots = qMin(m_tracks.slotCount(), store.size());
+    for (int slot = 0; slot < slots; ++slot)
     {
-        const int id = it.key();
-        const QVector<QPointF>& scenePts = it.value();
-        if (scenePts.size() < 2)
+        if (m_tracks.size(slot) < 2)
+            continue;
+        if (!m_tracks.bounds(slot).adjusted(-trackMargin, -trackMargin, trackMargin, trackMargin).intersects(dirtyScene))
             continue;
 
-        QPolygon poly;
-        poly.reserve(scenePts.size());
-        for (const QPointF& sp : scenePts)
-            poly << m_view->mapFromScene(sp);
+        const QPointF* pts = nullptr;
+        const int n = m_trackLod.simplified(m_tracks, slot, pts);
+        if (n < 2)
+            continue;
+
+        poly.resize(n);
+        for (int i = 0; i < n; ++i)
+            poly[i] = m_view->mapFromScene(pts[i]);
 
         // 选中目标更粗更亮
         QPen pen;
-        if (id == m_selectedId)
+        if (store.id(slot) == m_selectedId || store.testFlag(slot, MapTargetStore::Selected))
         {
             pen = QPen(QColor(255, 255, 0, 220), 2.5);  // 黄
         }
@@ -367,16 +373,19 @@ void MapOverlayWidget::paintEvent(QPaintEvent* e)
     }
 
     // ========= 2) 画最新点（圆点） =========
-    for (auto it = m_targetScenePos.begin(); it != m_targetScenePos.end(); ++it)
+    // 由网格索引取出重绘范围内的目标，不再逐个变换后丢弃
+    const double markerMargin = MARKER_DIRTY_MARGIN / scale;
+    m_visibleTargets.resize(0);
+    store.query(dirtyScene.adjusted(-markerMargin, -markerMargin, markerMargin, markerMargin), m_visibleTargets);
+    for (int i : qAsConst(m_visibleTargets))
     {
-        const int id = it.key();
-        const QPoint viewPos = m_view->mapFromScene(it.value());
+        const QPoint viewPos = m_view->mapFromScene(store.scenePos(i));
 
         // 视野外不画
         if (!rect().contains(viewPos))
             continue;
 
-        const bool selected = (id == m_selectedId);
+        const bool selected = store.id(i) == m_selectedId || store.testFlag(i, MapTargetStore::Selected);
 
         QPen pen(selected ? QColor(255,255,0,240) : QColor(0,255,0,200));
         pen.setWidthF(selected ? 2.2 : 1.8);
@@ -389,7 +398,188 @@ void MapOverlayWidget::paintEvent(QPaintEvent* e)
 
         // 可选：画 ID
         // p.setPen(QColor(255,255,255,200));
-        // p.drawText(viewPos + QPoint(8, -8), QString::number(id));
+        // p.drawText(viewPos + QPoint(8, -8), QString::number(store.id(i)));
+    }
+}
+
+/**
+ * @brief 使 HUD 缓存失效，下次绘制时重画
+ */
+void MapOverlayWidget::invalidateHud()
+{
+    m_hudDirty = true;
+    update();
+}
+
+/**
+ * @brief 检查 HUD 缓存是否仍有效（视图变换、雷达中心的 view 坐标、尺寸、设备像素比都未变），
+ *        失效时重画到缓存图像中
+ */
+void MapOverlayWidget::updateHudCache()
+{
+    const QPointF centerView = m_view->mapFromScene(m_radarCenterScene);
+    const double s = m_view->transform().m11();
+    const qreal dpr = devicePixelRatioF();
+
+    if (!m_hudDirty && !m_hudCache.isNull() &&
+        m_hudCenterView == centerView && m_hudScale == s &&
+        m_hudCache.size() == size() * dpr && m_hudCache.devicePixelRatio() == dpr)
+    {
+        return;
+    }
+
+    m_hudCache = QPixmap(size() * dpr);
+    m_hudCache.setDevicePixelRatio(dpr);
+    m_hudCache.fill(Qt::transparent);
+
+    QPainter hp(&m_hudCache);
+    hp.setRenderHint(QPainter::Antialiasing, true);
+    hp.setFont(font());
+    drawHud(hp, centerView);
+
+    m_hudCenterView = centerView;
+    m_hudScale      = s;
+    m_hudDirty      = false;
+}
+
+/**
+ * @brief            雷达 HUD：同心圆、十字线、米字线及每圈的距离标注
+ * @param p          目标画笔（绘制到缓存图像）
+ * @param centerView 雷达中心的 view 坐标
+ */
+void MapOverlayWidget::drawHud(QPainter& p, const QPointF& centerView)
+{
+    // 米 -> scene像素（scene 像素即 scene 级别的像素，与显示级别无关）
+    const double metersPerPixel =
+        Bing::groundResolution(m_radarCenterLatDeg, m_view->sceneZoomLevel());
+
+    // scene像素 -> view像素
+    const double s = m_view->transform().m11();
+    auto metersToViewPx = [&](double meters) -> double {
+        return (meters / metersPerPixel) * s;
+    };
+
+    // ===== 雷达绿配色（只靠透明度区分） =====
+    const QColor greenMajor(0, 255, 120, 200);
+    const QColor greenMid  (0, 255, 120, 150);
+    const QColor greenMinor(0, 255, 120, 100);
+    const QColor greenFaint(0, 255, 120, 70);
+
+    p.setBrush(Qt::NoBrush);
+
+    // ===== 同心圆（全虚线）=====
+    for (double meters : m_ringMeters)
+    {
+        const double r = metersToViewPx(meters);
+        const bool isMajor =
+            (m_majorRingStepMeters > 0) &&
+            (qRound(meters) % m_majorRingStepMeters == 0);
+
+        QPen pen;
+        if (isMajor)
+        {
+            pen = QPen(greenMid, 1.8);
+            pen.setDashPattern({6, 6});
+        }
+        else
+        {
+            pen = QPen(greenMinor, 1.2);
+            pen.setDashPattern({4, 6});
+        }
+
+        pen.setCapStyle(Qt::RoundCap);
+        p.setPen(pen);
+
+        QRectF rc(centerView.x() - r, centerView.y() - r, r * 2, r * 2);
+        p.drawEllipse(rc);
+    }
+
+    // ===== 主十字线（虚线，最强）=====
+    const double arm = metersToViewPx(m_crossArmMeters);
+    {
+        QPen pen(greenMajor, 2.4);
+        pen.setDashPattern({8, 6});
+        pen.setCapStyle(Qt::RoundCap);
+        p.setPen(pen);
+
+        p.drawLine(QPointF(centerView.x() - arm, centerView.y()),
+                   QPointF(centerView.x() + arm, centerView.y()));
+        p.drawLine(QPointF(centerView.x(), centerView.y() - arm),
+                   QPointF(centerView.x(), centerView.y() + arm));
+    }
+
+    // ===== 米字线（45°，虚线，中等）=====
+    {
+        QPen pen(greenMid, 1.6);
+        pen.setDashPattern({6, 6});
+        pen.setCapStyle(Qt::RoundCap);
+        p.setPen(pen);
+
+        const double d = arm / std::sqrt(2.0);
+
+        p.drawLine(QPointF(centerView.x() - d, centerView.y() - d),
+                   QPointF(centerView.x() + d, centerView.y() + d));
+        p.drawLine(QPointF(centerView.x() - d, centerView.y() + d),
+                   QPointF(centerView.x() + d, centerView.y() - d));
+    }
+
+    // ===== 中心弱点（可选）=====
+    {
+        p.setPen(Qt::NoPen);
+        p.setBrush(greenFaint);
+        p.drawEllipse(centerView, 3.0, 3.0);
+    }
+
+    // ===== 每个同心圆只显示一个距离值：统一在水平线右侧 =====
+    {
+        // 文本样式（清晰但不抢画面）
+        QFont f = p.font();
+        f.setPixelSize(13);
+        f.setBold(true);
+        p.setFont(f);
+
+        const QColor textColor(0, 255, 120, 200);
+        QPen textPen(textColor);
+        p.setPen(textPen);
+
+        QFontMetrics fm(p.font());
+
+        // 轻微背景块，让字在地图上更清晰（不想要可删掉背景那几行）
+        auto drawTag = [&](const QPointF& anchor, const QString& txt)
+        {
+            const int w = fm.horizontalAdvance(txt);
+            const int h = fm.height();
+
+            QRectF box(anchor.x(),
+                       anchor.y() - h + 4,
+                       w + 10,
+                       h + 6);
+
+            p.setPen(Qt::NoPen);
+            p.setBrush(QColor(0, 0, 0, 90));
+            p.drawRoundedRect(box, 6, 6);
+
+            p.setPen(textPen);
+            p.drawText(box.adjusted(6, 0, -4, 0),
+                       Qt::AlignVCenter | Qt::AlignLeft,
+                       txt);
+        };
+
+        // 逐圈标注：每个圈只标一个值（右侧）
+        for (int i = 0; i < m_ringMeters.size(); ++i)
+        {
+            const double meters = m_ringMeters[i];
+            const double r = metersToViewPx(meters);
+
+            // 文字内容
+            const QString txt = QString::number(int(qRound(meters))) + "m";
+
+            // 位置：水平线右侧，稍微上移避免压线
+            // 如果你觉得文字太靠近线，可以把 -16 改成 -20 或 -24
+            QPointF pos(centerView.x() + r + 8.0, centerView.y() - 16.0);
+
+            drawTag(pos, txt);
+        }
     }
 }
 
@@ -403,6 +593,7 @@ void MapOverlayWidget::setRadarParams(const QPointF& centerScene,
     m_radarCenterLatDeg = centerLatDeg;
     m_ringMeters = ringMeters;
     m_crossArmMeters = crossArmMeters;
+    invalidateHud();
 }
 
 void MapOverlayWidget::startCreateCircleZone()
@@ -439,8 +630,11 @@ void MapOverlayWidget::clearAlertZones()
 {
     m_circleZones.clear();
     m_polygonZones.clear();
+    publishZones(MapAlertZoneSnapshot(new MapAlertZoneIndex));
+    m_alertWorker.resetState();
     m_polygonTempScenePoints.clear();
-    m_alarmTargets.clear();
+    if (m_view)
+        m_view->targetStore().clearFlag(MapTargetStore::InAlertZone);
     stopAlertEdit();
 }
 
@@ -487,7 +681,7 @@ void MapOverlayWidget::mousePressEvent(QMouseEvent* e)
             {
                 PolygonAlertZone zone;
                 zone.pointsScene = m_polygonTempScenePoints;
-                m_polygonZones.append(zone);
+                addPolygonZone(zone);
             }
             m_polygonTempScenePoints.clear();
             stopAlertEdit();
@@ -527,7 +721,7 @@ void MapOverlayWidget::mouseReleaseEvent(QMouseEvent* e)
             CircleAlertZone zone;
             zone.centerScene = m_circleCenterScene;
             zone.radiusScene = m_circleRadiusScene;
-            m_circleZones.append(zone);
+            addCircleZone(zone);
         }
 
         m_circleCenterSet = false;
@@ -541,48 +735,79 @@ void MapOverlayWidget::mouseReleaseEvent(QMouseEvent* e)
     e->ignore();
 }
 
-void MapOverlayWidget::checkAlertZones(int targetId, const QPointF& targetScenePos)
+void MapOverlayWidget::addCircleZone(const CircleAlertZone& zone)
 {
-    bool inAnyZone = false;
+    m_circleZones.append(zone);
 
-    // 1) 圆
-    for (const auto& c : m_circleZones)
-    {
-        if (QLineF(targetScenePos, c.centerScene).length() <= c.radiusScene)
-        {
-            inAnyZone = true;
-            break;
-        }
-    }
+    QSharedPointer<MapAlertZoneIndex> next(new MapAlertZoneIndex(*m_zones));
+    next->addCircle(zone.centerScene, zone.radiusScene);
+    publishZones(next);
+    update();
+}
 
-    // 2) 多边形（只有当圆没命中时再算，省一点）
-    if (!inAnyZone)
-    {
-        for (const auto& poly : m_polygonZones)
-        {
-            QPolygonF polygon(poly.pointsScene);
-            if (polygon.containsPoint(targetScenePos, Qt::OddEvenFill))
-            {
-                inAnyZone = true;
-                break;
-            }
-        }
-    }
+void MapOverlayWidget::addPolygonZone(const PolygonAlertZone& zone)
+{
+    if (zone.pointsScene.size() < 3)
+        return;
 
-    // ===== 状态机：进入/离开 =====
-    const bool wasIn = m_alarmTargets.contains(targetId);
+    m_polygonZones.append(zone);
 
-    if (inAnyZone && !wasIn)
+    QSharedPointer<MapAlertZoneIndex> next(new MapAlertZoneIndex(*m_zones));
+    next->addPolygon(zone.pointsScene);
+    publishZones(next);
+    update();
+}
+
+/**
+ * @brief       替换警戒区快照：工作线程正在使用的旧快照由其自身引用保持到用完
+ * @param zones 新快照
+ */
+void MapOverlayWidget::publishZones(const MapAlertZoneSnapshot& zones)
+{
+    m_zones = zones;
+    m_alertWorker.setZones(m_zones);
+}
+
+void MapOverlayWidget::checkAlertZones(int targetId, const QPointF& targetScenePos)
+{
+    m_alertWorker.submit({MapAlertSample{targetId, targetScenePos}});
+}
+
+void MapOverlayWidget::checkAlertZones(const QVector<int>& indices)
+{
+    if (!m_view || indices.isEmpty())
+        return;
+    const MapTargetStore& store = m_view->targetStore();
+
+    QVector<MapAlertSample> samples(indices.size());
+    for (int k = 0; k < indices.size(); ++k)
+        samples[k] = MapAlertSample{store.id(indices[k]), store.scenePos(indices[k])};
+    m_alertWorker.submit(samples);
+}
+
+// ===== 状态机：进入/离开（判断在工作线程，这里同步到目标存储的标志位并发信号） =====
+void MapOverlayWidget::onAlertEntered(int targetId)
+{
+    if (m_view)
     {
-        m_alarmTargets.insert(targetId);
-        emit sgnAlertTriggered(targetId);   // 进入触发
+        MapTargetStore& store = m_view->targetStore();
+        const int index = store.indexOf(targetId);
+        if (index >= 0)
+            store.setFlag(index, MapTargetStore::InAlertZone);
     }
-    else if (!inAnyZone && wasIn)
+    emit sgnAlertTriggered(targetId);   // 进入触发
+}
+
+void MapOverlayWidget::onAlertLeft(int targetId)
+{
+    if (m_view)
     {
-        m_alarmTargets.remove(targetId);    // 离开移除（你要的）
-        // 如果你需要“离开事件”，这里可以加一个 signal
-        // emit sgnAlertCleared(targetId);
+        MapTargetStore& store = m_view->targetStore();
+        const int index = store.indexOf(targetId);
+        if (index >= 0)
+            store.setFlag(index, MapTargetStore::InAlertZone, false);   // 离开移除
     }
+    emit sgnAlertCleared(targetId);
 }
 
 
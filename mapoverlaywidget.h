@@ -1,5 +1,8 @@
 #pragma once
-#include "LXMapGraphicsView.h" // 为了复用 RadarTargetData（你也可以把 RadarTargetData 抽到单独头文件）
+#include "LXMapGraphicsView.h"
+#include "mapalertworker.h"
+#include "maptracklod.h"
+#include "maptrackpool.h"
 #include <QWidget>
 #include <QMap>
 #include <QPointer>
@@ -29,14 +32,19 @@ class MAPGRAPHICSVIEW_EXPORT MapOverlayWidget : public QWidget
 public:
     explicit MapOverlayWidget(LXMapGraphicsView* view);
 
-    void setTargets(const QMap<int, RadarTargetData>& targets);
-    void setTargetScenePos(int targetId, const QPointF& scenePos);
+    // 目标存储中第 index 个目标已更新：重绘新旧位置并追加航迹点
+    void updateTarget(int index);
     void setSelectedTarget(int targetId);
+    // 框选结果（目标存储中的 Selected 标志）变化后调用，重绘新旧选中目标
+    void selectionChanged(const QVector<int>& changedIndices);
 
     // ✅ 新增：追加航迹点（内部自动限长）
     void appendTrackPoint(int id, const QPointF& scenePos);
+    // 每条航迹保留的点数（默认 60，最多 MAX_TRACK_POINTS）
+    void setMaxTrackPoints(int points);
+    int maxTrackPoints() const { return m_tracks.capacity(); }
 
-    bool hasTarget(int targetId) const { return m_targets.contains(targetId); }
+    bool hasTarget(int targetId) const { return m_view && m_view->targetStore().contains(targetId); }
     QPoint viewPosOf(int targetId) const;          // scene -> view
     bool isTargetInView(int targetId) const;       // 是否在 viewport 视野内
 
@@ -46,13 +54,24 @@ public:
                         double centerLatDeg,
                         const QVector<double>& ringMeters,
                         double crossArmMeters);
+    void invalidateHud();   // HUD 缓存失效（参数变化时自动调用）
 
+    // 提交累积的脏区域（由视图按帧调用）
+    void flushDirty();
+
+    // 以代码方式添加警戒区（与界面绘制的警戒区一起登记到索引）
+    void addCircleZone(const CircleAlertZone& zone);
+    void addPolygonZone(const PolygonAlertZone& zone);
+    // 警戒判断在工作线程中进行：这里只提交位置，进入/离开稍后以 sgnAlertTriggered / sgnAlertCleared 发出
     void checkAlertZones(int targetId, const QPointF& targetScenePos);
+    // 整批提交（目标存储下标）
+    void checkAlertZones(const QVector<int>& indices);
 
     void initAlertButtons();
     void layoutAlertButtons(); // 处理 resize 时保持位置
 signals:
     void sgnAlertTriggered(int targetId);   // 你也可以用 batchId/targetId
+    void sgnAlertCleared(int targetId);     // 目标离开全部警戒区
 
 public slots:
     void startCreateCircleZone();
@@ -70,20 +89,33 @@ protected:
     bool event(QEvent* e) override;
 
 private:
+    QRect sceneToViewRect(const QRectF& sceneRect, int margin) const;
+    QRect markerViewRect(const QPointF& scenePos) const;   // 目标圆点的重绘范围
+    QRect targetViewRect(int id) const;                   // 目标圆点 + 航迹的重绘范围
+    void appendTrackPointAt(int index, const QPointF& scenePos);
+    void publishZones(const MapAlertZoneSnapshot& zones);
+    void onAlertEntered(int targetId);
+    void onAlertLeft(int targetId);
+    void markDirty(const QRect& viewRect);                // 累积脏区域，下一帧统一重绘
+    void updateHudCache();
+    void drawHud(QPainter& p, const QPointF& centerView);
     bool forwardToViewport(QEvent* e);
     bool hitOnButtons(const QPoint& pos) const;
 
 private:
     QPointer<LXMapGraphicsView> m_view;
-    QMap<int, RadarTargetData> m_targets;          // 最新目标数据（用于显示数值）
-    QMap<int, QPointF> m_targetScenePos;           // 最新目标点（scene 像素坐标）
 
     // 航迹（scene 点序列）
-    QMap<int, QVector<QPointF>> m_tracks;
+    MapTrackPool m_tracks{60};   // 航迹号 = 目标存储下标
+    MapTrackLod m_trackLod;      // 按缩放简化后的航迹（绘制用缓存）
+    QVector<int> m_visibleTargets;   // 绘制时的查询结果（复用缓冲）
 
     constexpr static double TARGET_SIZE = 10.0;
+    constexpr static int MARKER_DIRTY_MARGIN = 9;   // 圆点半径 6 + 线宽 + 抗锯齿
+    constexpr static int TRACK_DIRTY_MARGIN  = 3;   // 航迹线宽 2.5 + 抗锯齿
+    constexpr static int MAX_DIRTY_RECTS     = 32;  // 超过后合并成包围矩形
     int m_selectedId = -1;
-    int m_maxTrackPoints = 60;  // 你想更长就调大（比如 100/200）
+    constexpr static int MAX_TRACK_POINTS = 10000;
 
 private:
     bool m_hasRadar = false;
@@ -95,10 +127,20 @@ private:
     int m_majorRingStepMeters = 600;  // 主圈步进（粗）
     int m_minorRingStepMeters = 300;  // 辅圈步进（细）
 
+    QVector<QRect> m_dirtyRects;   // 尚未提交的重绘区域
+
+    // HUD 缓存：静态的圈/线/标注只在视图变换、尺寸或参数变化时重画
+    QPixmap m_hudCache;
+    bool    m_hudDirty = true;
+    QPointF m_hudCenterView;
+    double  m_hudScale = 0.0;
+
     AlertEditMode m_alertMode = AlertEditMode::None;
 
     QVector<CircleAlertZone>  m_circleZones;
     QVector<PolygonAlertZone> m_polygonZones;
+    MapAlertZoneSnapshot m_zones;    // 圆/多边形的网格 + 边表索引快照（编辑时复制后替换）
+    MapAlertWorker m_alertWorker;    // 警戒判断工作线程
 
     // 圆形创建过程
     bool   m_circleCenterSet = false;
@@ -108,9 +150,6 @@ private:
     // 多边形创建过程
     QVector<QPointF> m_polygonTempScenePoints;
 
-    // 已经触发报警的目标（避免重复报警）
-    QSet<int> m_alarmTargets;
-
     QPushButton* m_btnCircle  = nullptr;
     QPushButton* m_btnPolygon = nullptr;
     QPushButton* m_btnClear   = nullptr;
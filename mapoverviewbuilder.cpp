@@ -0,0 +1,249 @@
+#include "mapoverviewbuilder.h"
+
+#include "mapStruct.h"
+#include "maptilearchive.h"
+#include "maptilecatalog.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSet>
+#include <QVector>
+#include <QtConcurrent>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LX_HAVE_SSE2 1
+#endif
+
+namespace {
+constexpr int TILE_SIZE = 256;
+constexpr int JPEG_QUALITY = 90;
+
+// 一个像素的 2×2 平均（逐通道，四舍五入）
+inline quint32 average4(quint32 a, quint32 b, quint32 c, quint32 d)
+{
+    const quint32 rb = ((a & 0x00FF00FF) + (b & 0x00FF00FF) + (c & 0x00FF00FF) + (d & 0x00FF00FF) + 0x00020002) >> 2;
+    const quint32 ag = (((a >> 8) & 0x00FF00FF) + ((b >> 8) & 0x00FF00FF) +
+                        ((c >> 8) & 0x00FF00FF) + ((d >> 8) & 0x00FF00FF) + 0x00020002) >> 2;
+    return (rb & 0x00FF00FF) | ((ag & 0x00FF00FF) << 8);
+}
+
+#ifdef LX_HAVE_SSE2
+// 两行各 8 个像素 → 4 个输出像素
+inline __m128i average8x2(const quint32* row0, const quint32* row1)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0));
+    const __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + 4));
+    const __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1));
+    const __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + 4));
+
+    // 纵向求和（16 位，每个寄存器 2 个像素）
+    const __m128i v0 = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(b0, zero));   // 像素 0,1
+    const __m128i v1 = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(b0, zero));   // 像素 2,3
+    const __m128i v2 = _mm_add_epi16(_mm_unpacklo_epi8(a1, zero), _mm_unpacklo_epi8(b1, zero));   // 像素 4,5
+    const __m128i v3 = _mm_add_epi16(_mm_unpackhi_epi8(a1, zero), _mm_unpackhi_epi8(b1, zero));   // 像素 6,7
+
+    // 横向求和：高 64 位加到低 64 位
+    const __m128i h0 = _mm_add_epi16(v0, _mm_srli_si128(v0, 8));
+    const __m128i h1 = _mm_add_epi16(v1, _mm_srli_si128(v1, 8));
+    const __m128i h2 = _mm_add_epi16(v2, _mm_srli_si128(v2, 8));
+    const __m128i h3 = _mm_add_epi16(v3, _mm_srli_si128(v3, 8));
+
+    const __m128i round = _mm_set1_epi16(2);
+    const __m128i o01 = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(h0, h1), round), 2);
+    const __m128i o23 = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(h2, h3), round), 2);
+    return _mm_packus_epi16(o01, o23);
+}
+#endif
+
+QString tilePath(const QString& root, int z, int x, int y)
+{
+    return root + QString("/%1/%2/%3.jpg").arg(z).arg(x).arg(y);
+}
+
+// 删除已合并进瓦片包的中间文件，以及因此变空的列目录、级别目录（非空目录 rmdir 会失败，不受影响）
+void removeStaged(const QString& root, const QVector<TileKey>& staged)
+{
+    QDir dir(root);
+    QSet<quint64> columns;
+    for (const TileKey& t : staged)
+    {
+        QFile::remove(tilePath(root, t.z, t.x, t.y));
+        columns.insert(MapTileKey::encode(t.z, t.x, 0));
+    }
+
+    QSet<int> levels;
+    for (quint64 c : qAsConst(columns))
+    {
+        const int z = MapTileKey::level(c);
+        dir.rmdir(QString("%1/%2").arg(z).arg(MapTileKey::tileX(c)));
+        levels.insert(z);
+    }
+    for (int z : qAsConst(levels))
+        dir.rmdir(QString::number(z));
+}
+
+// 读取子瓦片：优先目录（含刚生成的级别），其次瓦片包
+QImage loadTile(const QString& root, const MapTileArchive& archive, int z, int x, int y)
+{
+    QImage img;
+    const QString path = tilePath(root, z, x, y);
+    if (QFileInfo::exists(path))
+        img.load(path);
+    else if (archive.isOpen())
+        img.loadFromData(archive.tileData(TileKey(z, x, y)));
+    return img;
+}
+}   // namespace
+
+/**
+ * @brief           2×2 盒式滤波降采样（等价于半像素中心的双线性插值）
+ * @param src       源像素，2w×2h
+ * @param srcStride 源每行像素数
+ * @param dst       目标像素，w×h
+ * @param dstStride 目标每行像素数
+ */
+void MapOverviewBuilder::boxFilter2x(const quint32* src, int srcStride,
+                                     quint32* dst, int dstStride, int w, int h)
+{
+    for (int y = 0; y < h; ++y)
+    {
+        const quint32* row0 = src + qptrdiff(2 * y) * srcStride;
+        const quint32* row1 = row0 + srcStride;
+        quint32* out = dst + qptrdiff(y) * dstStride;
+
+        int x = 0;
+#ifdef LX_HAVE_SSE2
+        for (; x + 4 <= w; x += 4)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + x), average8x2(row0 + 2 * x, row1 + 2 * x));
+#endif
+        for (; x < w; ++x)
+            out[x] = average4(row0[2 * x], row0[2 * x + 1], row1[2 * x], row1[2 * x + 1]);
+    }
+}
+
+/**
+ * @brief 2×2 子瓦片合成一块父瓦片，每块子瓦片降采样到父瓦片的一个象限
+ */
+QImage MapOverviewBuilder::downsample2x2(const QImage& topLeft, const QImage& topRight,
+                                         const QImage& bottomLeft, const QImage& bottomRight)
+{
+    QImage out(TILE_SIZE, TILE_SIZE, QImage::Format_RGB32);
+    out.fill(Qt::white);   // 缺失的子瓦片留白
+
+    const QImage* children[4] = {&topLeft, &topRight, &bottomLeft, &bottomRight};
+    const int half = TILE_SIZE / 2;
+    for (int i = 0; i < 4; ++i)
+    {
+        if (children[i]->isNull())
+            continue;
+
+        QImage child = children[i]->convertToFormat(QImage::Format_RGB32);
+        if (child.size() != QSize(TILE_SIZE, TILE_SIZE))
+            child = child.scaled(TILE_SIZE, TILE_SIZE, Qt::IgnoreAspectRatio, Qt::FastTransformation);
+
+        const int ox = (i & 1) * half;
+        const int oy = (i >> 1) * half;
+        boxFilter2x(reinterpret_cast<const quint32*>(child.constBits()), child.bytesPerLine() / 4,
+                    reinterpret_cast<quint32*>(out.scanLine(oy)) + ox, out.bytesPerLine() / 4,
+                    half, half);
+    }
+    return out;
+}
+
+/**
+ * @brief             由 baseZoom 级瓦片逐级生成到 minZoom
+ * @param mapRootPath 离线地图根目录
+ * @param baseZoom    已有的最高级别
+ * @param minZoom     生成到的最低级别
+ * @param error       失败原因（可为空）
+ * @return            新生成的瓦片数，失败返回 -1
+ */
+int MapOverviewBuilder::build(const QString& mapRootPath, int baseZoom, int minZoom, QString* error)
+{
+    auto fail = [error](const QString& msg) {
+        if (error)
+            *error = msg;
+        return -1;
+    };
+
+    const QString archivePath = mapRootPath + "/" + MapTileArchive::defaultFileName();
+    MapTileArchive archive;
+    MapTileCatalog catalog;
+    if (QFileInfo::exists(archivePath) && archive.open(archivePath))
+        catalog.buildFromArchive(archive);
+    else
+        catalog.loadOrScan(mapRootPath);
+
+    if (!catalog.hasLevel(baseZoom))
+        return fail(QString("level %1 not found in %2").arg(baseZoom).arg(mapRootPath));
+
+    int generated = 0;
+    QVector<TileKey> staged;   // 本次写出的瓦片文件（合并进瓦片包后删除）
+    QList<QPoint> children = catalog.tiles(baseZoom);
+    for (int z = baseZoom - 1; z >= qMax(1, minZoom); --z)
+    {
+        // 1) 本级需要的父瓦片 = 下一级瓦片编号各除以 2（已存在的跳过）
+        QSet<quint64> seen;
+        QVector<QPoint> parents;
+        QList<QPoint> levelTiles;
+        for (const QPoint& c : qAsConst(children))
+        {
+            const QPoint p(c.x() >> 1, c.y() >> 1);
+            const quint64 k = MapTileKey::encode(z, p.x(), p.y());
+            if (seen.contains(k))
+                continue;
+            seen.insert(k);
+            levelTiles.append(p);
+            if (!catalog.contains(z, p.x(), p.y()))
+                parents.append(p);
+        }
+
+        // 2) 并行生成（每个父瓦片独立读 4 块子瓦片、降采样、编码）
+        QAtomicInt written = 0;
+        QAtomicInt failed  = 0;
+        QtConcurrent::blockingMap(parents, [&](const QPoint& p) {
+            const int cx = p.x() * 2, cy = p.y() * 2;
+            const QImage tile = downsample2x2(loadTile(mapRootPath, archive, z + 1, cx,     cy),
+                                              loadTile(mapRootPath, archive, z + 1, cx + 1, cy),
+                                              loadTile(mapRootPath, archive, z + 1, cx,     cy + 1),
+                                              loadTile(mapRootPath, archive, z + 1, cx + 1, cy + 1));
+
+            const QString dirPath = mapRootPath + QString("/%1/%2").arg(z).arg(p.x());
+            if (QDir().mkpath(dirPath) &&
+                tile.save(tilePath(mapRootPath, z, p.x(), p.y()), "JPG", JPEG_QUALITY))
+                written.fetchAndAddRelaxed(1);
+            else
+                failed.fetchAndAddRelaxed(1);
+        });
+
+        if (failed.loadRelaxed() > 0)
+            return fail(QString("failed to write %1 tiles of level %2").arg(failed.loadRelaxed()).arg(z));
+
+        generated += written.loadRelaxed();
+        for (const QPoint& p : qAsConst(parents))
+            staged.append(TileKey(z, p.x(), p.y()));
+        children = levelTiles;
+    }
+
+    // 3) 刷新持久化的瓦片目录；原来用瓦片包的，把新级别合并进包，
+    //    合并成功后删掉中间文件（打包失败时保留，下次可直接重新打包）
+    if (archive.isOpen())
+    {
+        archive.close();
+        if (staged.isEmpty())
+            return generated;
+
+        QString packError;
+        if (!MapTileArchive::pack(mapRootPath, archivePath, &packError))
+            return fail(packError);
+        removeStaged(mapRootPath, staged);
+    }
+    else
+    {
+        MapTileCatalog().loadOrScan(mapRootPath);
+    }
+
+    return generated;
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include "mapgraphicsview_global.h"
+#include <QImage>
+#include <QString>
+
+// 概览级别生成：由已有的高级别瓦片 2×2 降采样生成低级别瓦片（17 → 16 → 15 ...），
+// 每一级内部按父瓦片并行（使用全部核心），逐级向下。
+// 结果写入 mapRoot/z/x/y.jpg；若 mapRoot 下已有瓦片包，会把新级别合并进瓦片包并删掉这些中间文件。
+// 耗时较长，请在工作线程中调用（如 QtConcurrent::run）。
+class MAPGRAPHICSVIEW_EXPORT MapOverviewBuilder
+{
+public:
+    // 从 baseZoom 逐级生成到 minZoom（已存在的瓦片跳过），返回生成的瓦片数，失败返回 -1
+    static int build(const QString& mapRootPath, int baseZoom, int minZoom, QString* error = nullptr);
+
+    // 把 2×2 块 256×256 瓦片合成一块 256×256 瓦片（缺失的子瓦片传空图像）
+    static QImage downsample2x2(const QImage& topLeft, const QImage& topRight,
+                                const QImage& bottomLeft, const QImage& bottomRight);
+
+    // 2×2 盒式滤波（32 位像素，逐通道四舍五入平均），dst 为 w×h，src 为 2w×2h，stride 以像素为单位
+    static void boxFilter2x(const quint32* src, int srcStride,
+                            quint32* dst, int dstStride, int w, int h);
+};
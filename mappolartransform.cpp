@@ -0,0 +1,87 @@
+#include "mappolartransform.h"
+
+#include "bingformula.h"
+#include <QtMath>
+#include <cmath>
+
+namespace {
+constexpr double EARTH_RADIUS = 6378137.0;   // 与 Bing 投影相同的球半径
+constexpr int BATCH_BLOCK = 256;
+}
+
+MapPolarTransform::MapPolarTransform(double siteLon, double siteLat, int sceneZoom,
+                                     const QPointF& originScene, Mode mode)
+    : m_valid(true)
+    , m_mode(mode)
+    , m_zoom(sceneZoom)
+    , m_origin(originScene)
+    , m_pixelsPerMeter(1.0 / Bing::groundResolution(siteLat, sceneZoom))
+    , m_siteLonDeg(Bing::clipLon(siteLon))
+    , m_siteLatDeg(Bing::clipLat(siteLat))
+{
+    const double latRad = qDegreesToRadians(m_siteLatDeg);
+    m_sinLat = std::sin(latRad);
+    m_cosLat = std::cos(latRad);
+
+    double px = 0.0, py = 0.0;
+    Bing::latLongToPixelXY(&m_siteLonDeg, &m_siteLatDeg, 1, sceneZoom, &px, &py);
+    m_sitePixel = QPointF(px, py);
+}
+
+QPointF MapPolarTransform::toScene(double azimuthDeg, double rangeMeters) const
+{
+    QPointF out;
+    toScene(&azimuthDeg, &rangeMeters, 1, &out);
+    return out;
+}
+
+/**
+ * @brief             批量极坐标转 scene 坐标
+ *                    近似模式：dx = r·k·sinθ，dy = -r·k·cosθ（k 为站址处的像素/米，创建时算好）；
+ *                    精确模式：球面大圆求目标经纬度，分块调用 Bing 批量投影，再减去站址像素
+ * @param azimuthDeg  方位角（度，正北顺时针）
+ * @param rangeMeters 距离（米）
+ * @param count       点数
+ * @param out         输出 scene 坐标
+ */
+void MapPolarTransform::toScene(const double* azimuthDeg, const double* rangeMeters, int count, QPointF* out) const
+{
+    if (!m_valid)
+        return;
+
+    if (m_mode == LocalScale)
+    {
+        const double k = m_pixelsPerMeter;
+        for (int i = 0; i < count; ++i)
+        {
+            const double rad = qDegreesToRadians(azimuthDeg[i]);
+            const double r = rangeMeters[i] * k;
+            out[i] = QPointF(m_origin.x() + r * std::sin(rad), m_origin.y() - r * std::cos(rad));
+        }
+        return;
+    }
+
+    double lon[BATCH_BLOCK], lat[BATCH_BLOCK];
+    for (int base = 0; base < count; base += BATCH_BLOCK)
+    {
+        const int n = qMin(BATCH_BLOCK, count - base);
+        for (int i = 0; i < n; ++i)
+        {
+            const double theta = qDegreesToRadians(azimuthDeg[base + i]);
+            const double delta = rangeMeters[base + i] / EARTH_RADIUS;
+            const double sinD = std::sin(delta), cosD = std::cos(delta);
+
+            const double sinLat2 = m_sinLat * cosD + m_cosLat * sinD * std::cos(theta);
+            const double dLon = std::atan2(std::sin(theta) * sinD * m_cosLat, cosD - m_sinLat * sinLat2);
+            lat[i] = qRadiansToDegrees(std::asin(qBound(-1.0, sinLat2, 1.0)));
+            lon[i] = m_siteLonDeg + qRadiansToDegrees(dLon);
+        }
+
+        Bing::latLongToPixelXY(lon, lat, n, m_zoom, lon, lat);
+
+        const double ox = m_origin.x() - m_sitePixel.x();
+        const double oy = m_origin.y() - m_sitePixel.y();
+        for (int i = 0; i < n; ++i)
+            out[base + i] = QPointF(lon[i] + ox, lat[i] + oy);
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include "mapgraphicsview_global.h"
+#include <QPointF>
+
+// 雷达站极坐标 → scene 坐标变换：按站址与 scene 级别创建一次，之后整批转换（方位、距离）。
+//   LocalScale    —— 全覆盖范围使用站址纬度的地面分辨率（与原 calcTargetScenePos 相同的近似）
+//   ExactMercator —— 按球面大圆求目标经纬度再做墨卡托投影，计入覆盖范围内随纬度变化的比例
+class MAPGRAPHICSVIEW_EXPORT MapPolarTransform
+{
+public:
+    enum Mode
+    {
+        LocalScale,
+        ExactMercator
+    };
+
+    MapPolarTransform() = default;
+    /**
+     * @param siteLon    站址经度
+     * @param siteLat    站址纬度
+     * @param sceneZoom  scene 坐标所用级别
+     * @param originScene 站址在 scene 中的位置（雷达圈的圆心，一般为像素取整后的站址）
+     * @param mode       变换方式
+     */
+    MapPolarTransform(double siteLon, double siteLat, int sceneZoom, const QPointF& originScene,
+                      Mode mode = LocalScale);
+
+    bool isValid() const { return m_valid; }
+    Mode mode() const { return m_mode; }
+    QPointF originScene() const { return m_origin; }
+    double siteLon() const { return m_siteLonDeg; }
+    double siteLat() const { return m_siteLatDeg; }
+    int sceneZoom() const { return m_zoom; }
+    double pixelsPerMeter() const { return m_pixelsPerMeter; }   // 站址处
+
+    QPointF toScene(double azimuthDeg, double rangeMeters) const;
+    // 批量转换：azimuthDeg / rangeMeters 各 count 个，结果写入 out
+    void toScene(const double* azimuthDeg, const double* rangeMeters, int count, QPointF* out) const;
+
+private:
+    bool m_valid = false;
+    Mode m_mode = LocalScale;
+    int m_zoom = 0;
+    QPointF m_origin;
+    double m_pixelsPerMeter = 0.0;
+    // 精确模式
+    double m_siteLonDeg = 0.0;
+    double m_siteLatDeg = 0.0;
+    double m_sinLat = 0.0, m_cosLat = 0.0;
+    QPointF m_sitePixel;   // 站址的 double 像素（与 m_origin 的差为取整误差）
+};
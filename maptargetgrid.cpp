@@ -0,0 +1,138 @@
+#include "maptargetgrid.h"
+
+#include <cmath>
+
+MapTargetGrid::MapTargetGrid(double cellSize)
+    : m_cell(cellSize > 0.0 ? cellSize : 256.0)
+{
+}
+
+void MapTargetGrid::setCellSize(double cellSize)
+{
+    if (cellSize <= 0.0 || cellSize == m_cell)
+        return;
+    m_cell = cellSize;
+    clear();
+}
+
+void MapTargetGrid::clear()
+{
+    m_cells.clear();
+    m_cellOf.clear();
+    m_slotInCell.clear();
+}
+
+qint64 MapTargetGrid::cellCoord(double v) const
+{
+    return qint64(std::floor(v / m_cell));
+}
+
+/**
+ * @brief       更新目标所在格子：同格直接返回，换格时从旧格子交换删除
+ * @param index 目标下标
+ * @param pos   新位置（scene 坐标）
+ */
+void MapTargetGrid::update(int index, const QPointF& pos)
+{
+    if (index >= m_slotInCell.size())
+    {
+        const int oldSize = m_slotInCell.size();
+        m_cellOf.resize(index + 1);
+        m_slotInCell.resize(index + 1);
+        for (int i = oldSize; i <= index; ++i)
+            m_slotInCell[i] = -1;
+    }
+
+    const quint64 key = packCell(cellCoord(pos.x()), cellCoord(pos.y()));
+    if (m_slotInCell[index] >= 0)
+    {
+        if (m_cellOf[index] == key)
+            return;
+
+        // 从旧格子删除：与末尾交换
+        auto old = m_cells.find(m_cellOf[index]);
+        QVector<int>& v = old.value();
+        const int slot = m_slotInCell[index];
+        const int moved = v.last();
+        v[slot] = moved;
+        m_slotInCell[moved] = slot;
+        v.removeLast();
+        if (v.isEmpty())
+            m_cells.erase(old);
+    }
+
+    QVector<int>& cell = m_cells[key];
+    m_cellOf[index]     = key;
+    m_slotInCell[index] = cell.size();
+    cell.append(index);
+}
+
+void MapTargetGrid::candidates(const QRectF& sceneRect, QVector<int>& out) const
+{
+    if (m_cells.isEmpty() || sceneRect.isEmpty())
+        return;
+
+    const qint64 x0 = cellCoord(sceneRect.left()),  x1 = cellCoord(sceneRect.right());
+    const qint64 y0 = cellCoord(sceneRect.top()),   y1 = cellCoord(sceneRect.bottom());
+
+    // 范围覆盖的格子比非空格子还多时，直接遍历非空格子
+    const double span = double(x1 - x0 + 1) * double(y1 - y0 + 1);
+    if (span > double(m_cells.size()))
+    {
+        for (auto it = m_cells.cbegin(); it != m_cells.cend(); ++it)
+        {
+            const qint64 cx = qint32(it.key() >> 32), cy = qint32(it.key() & 0xFFFFFFFFu);
+            if (cx >= x0 && cx <= x1 && cy >= y0 && cy <= y1)
+                out += it.value();
+        }
+        return;
+    }
+
+    for (qint64 cx = x0; cx <= x1; ++cx)
+    {
+        for (qint64 cy = y0; cy <= y1; ++cy)
+        {
+            auto it = m_cells.constFind(packCell(cx, cy));
+            if (it != m_cells.cend())
+                out += it.value();
+        }
+    }
+}
+
+void MapTargetGrid::query(const QRectF& sceneRect, const QVector<QPointF>& positions, QVector<int>& out) const
+{
+    QVector<int> found;
+    candidates(sceneRect, found);
+    for (int index : qAsConst(found))
+    {
+        if (sceneRect.contains(positions[index]))
+            out.append(index);
+    }
+}
+
+/**
+ * @brief           半径内最近的目标
+ * @param pos       查询点（scene 坐标）
+ * @param radius    半径（scene 单位）
+ * @param positions 目标位置列（下标与索引一致）
+ * @return          目标下标，没有返回 -1
+ */
+int MapTargetGrid::nearest(const QPointF& pos, double radius, const QVector<QPointF>& positions) const
+{
+    QVector<int> found;
+    candidates(QRectF(pos.x() - radius, pos.y() - radius, radius * 2, radius * 2), found);
+
+    int best = -1;
+    double bestDist2 = radius * radius;
+    for (int index : qAsConst(found))
+    {
+        const QPointF d = positions[index] - pos;
+        const double dist2 = d.x() * d.x() + d.y() * d.y();
+        if (dist2 <= bestDist2)
+        {
+            bestDist2 = dist2;
+            best = index;
+        }
+    }
+    return best;
+}
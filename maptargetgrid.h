@@ -0,0 +1,42 @@
+#pragma once
+#include "mapgraphicsview_global.h"
+#include <QHash>
+#include <QPointF>
+#include <QRectF>
+#include <QVector>
+
+// 目标空间索引（scene 坐标均匀网格）：
+//   每个格子记录落在其中的目标下标，目标移动时 O(1) 换格。
+//   用于点选（半径内最近目标）、视口裁剪和框选，耗时只与查询范围内的目标数有关。
+class MAPGRAPHICSVIEW_EXPORT MapTargetGrid
+{
+public:
+    explicit MapTargetGrid(double cellSize = 256.0);
+
+    void setCellSize(double cellSize);   // 会清空索引，需要重新 update
+    double cellSize() const { return m_cell; }
+
+    // 目标 index 移动到 pos（首次调用即插入）
+    void update(int index, const QPointF& pos);
+    void clear();
+
+    // 范围内（按格子粗筛）的目标下标追加到 out，调用方再按实际位置精确判断
+    void candidates(const QRectF& sceneRect, QVector<int>& out) const;
+    // 范围内的目标下标（精确）
+    void query(const QRectF& sceneRect, const QVector<QPointF>& positions, QVector<int>& out) const;
+    // 距 pos 不超过 radius 的最近目标下标，没有返回 -1
+    int nearest(const QPointF& pos, double radius, const QVector<QPointF>& positions) const;
+
+private:
+    static quint64 packCell(qint64 cx, qint64 cy)
+    {
+        return (quint64(quint32(qint32(cx))) << 32) | quint32(qint32(cy));
+    }
+    qint64 cellCoord(double v) const;
+
+private:
+    double m_cell = 256.0;
+    QHash<quint64, QVector<int>> m_cells;   // 格子 → 目标下标
+    QVector<quint64> m_cellOf;              // 目标所在格子
+    QVector<int> m_slotInCell;              // 目标在格子数组中的位置（-1 表示未插入）
+};
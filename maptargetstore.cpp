@@ -0,0 +1,75 @@
+#include "maptargetstore.h"
+
+/**
+ * @brief          插入或更新目标
+ * @param target   雷达目标数据
+ * @param scenePos 目标 scene 坐标
+ * @return         目标下标
+ */
+int MapTargetStore::upsert(const RadarTargetData& target, const QPointF& scenePos)
+{
+    auto it = m_index.find(target.targetId);
+    int index;
+    if (it != m_index.end())
+    {
+        index = it.value();
+        m_prevScenePos[index] = m_scenePos[index];
+        m_flags[index] |= HasPrevPos;
+    }
+    else
+    {
+        index = m_ids.size();
+        m_index.insert(target.targetId, index);
+
+        m_ids.append(target.targetId);
+        m_scenePos.append(QPointF());
+        m_prevScenePos.append(QPointF());
+        m_azimuth.append(0.0);
+        m_elevation.append(0.0);
+        m_range.append(0.0);
+        m_centerLat.append(0.0);
+        m_flags.append(0);
+    }
+
+    m_grid.update(index, scenePos);
+    m_scenePos[index]  = scenePos;
+    m_azimuth[index]   = target.azimuthDeg;
+    m_elevation[index] = target.elevationDeg;
+    m_range[index]     = target.rangeMeters;
+    m_centerLat[index] = target.centerLatDeg;
+    return index;
+}
+
+void MapTargetStore::clear()
+{
+    m_ids.clear();
+    m_scenePos.clear();
+    m_prevScenePos.clear();
+    m_azimuth.clear();
+    m_elevation.clear();
+    m_range.clear();
+    m_centerLat.clear();
+    m_flags.clear();
+    m_index.clear();
+    m_grid.clear();
+}
+
+RadarTargetData MapTargetStore::data(int index) const
+{
+    return RadarTargetData(m_ids[index], m_azimuth[index], m_elevation[index],
+                           m_range[index], m_centerLat[index]);
+}
+
+void MapTargetStore::setFlag(int index, Flag flag, bool on)
+{
+    if (on)
+        m_flags[index] |= flag;
+    else
+        m_flags[index] &= quint8(~flag);
+}
+
+void MapTargetStore::clearFlag(Flag flag)
+{
+    for (quint8& f : m_flags)
+        f &= quint8(~flag);
+}
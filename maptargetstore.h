@@ -0,0 +1,65 @@
+#pragma once
+#include "mapgraphicsview_global.h"
+#include "mapStruct.h"
+#include "maptargetgrid.h"
+#include <QHash>
+#include <QPointF>
+#include <QVector>
+
+// 雷达目标存储（结构数组）：每个字段一条连续数组，下标即目标序号，
+// id → 下标用一张哈希表。由 LXMapGraphicsView 持有，覆盖层只读引用，不再各自复制一份。
+// 目标只增不删（clear 除外），下标在两次 clear 之间保持不变。
+class MAPGRAPHICSVIEW_EXPORT MapTargetStore
+{
+public:
+    enum Flag : quint8
+    {
+        HasPrevPos  = 0x1,   // prevScenePos 有效（至少更新过两次）
+        InAlertZone = 0x2,   // 当前位于警戒区内
+        Selected    = 0x4,   // 框选选中
+    };
+
+    int size() const { return m_ids.size(); }
+    bool isEmpty() const { return m_ids.isEmpty(); }
+    bool contains(int id) const { return m_index.contains(id); }
+    int indexOf(int id) const { return m_index.value(id, -1); }
+
+    // 插入或更新一个目标，返回其下标；旧位置保存在 prevScenePos 中
+    int upsert(const RadarTargetData& target, const QPointF& scenePos);
+    void clear();
+
+    // 按下标访问
+    int id(int index) const { return m_ids[index]; }
+    const QPointF& scenePos(int index) const { return m_scenePos[index]; }
+    const QPointF& prevScenePos(int index) const { return m_prevScenePos[index]; }
+    double azimuthDeg(int index) const { return m_azimuth[index]; }
+    double elevationDeg(int index) const { return m_elevation[index]; }
+    double rangeMeters(int index) const { return m_range[index]; }
+    double centerLatDeg(int index) const { return m_centerLat[index]; }
+    RadarTargetData data(int index) const;
+
+    bool testFlag(int index, Flag flag) const { return m_flags[index] & flag; }
+    void setFlag(int index, Flag flag, bool on = true);
+    void clearFlag(Flag flag);   // 所有目标清除该标志
+
+    // 整列只读访问（绘制、拾取时顺序遍历）
+    const QVector<int>& ids() const { return m_ids; }
+    const QVector<QPointF>& scenePositions() const { return m_scenePos; }
+
+    // 空间查询（网格索引随 upsert 自动更新）
+    int nearest(const QPointF& scenePos, double radius) const { return m_grid.nearest(scenePos, radius, m_scenePos); }
+    void query(const QRectF& sceneRect, QVector<int>& out) const { m_grid.query(sceneRect, m_scenePos, out); }
+
+private:
+    QVector<int>     m_ids;
+    QVector<QPointF> m_scenePos;       // 最新位置（scene 像素坐标）
+    QVector<QPointF> m_prevScenePos;   // 上一次位置（用于局部重绘）
+    QVector<double>  m_azimuth;
+    QVector<double>  m_elevation;
+    QVector<double>  m_range;
+    QVector<double>  m_centerLat;
+    QVector<quint8>  m_flags;
+
+    QHash<int, int> m_index;           // id → 下标
+    MapTargetGrid m_grid;              // 位置的网格索引
+};
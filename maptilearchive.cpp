@@ -0,0 +1,255 @@
+#include "maptilearchive.h"
+
+#include "maptilecatalog.h"
+#include <QDebug>
+#include <QSaveFile>
+#include <QVector>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+const char ARCHIVE_MAGIC[4] = {'L', 'X', 'T', 'P'};
+constexpr quint32 ARCHIVE_VERSION = 3;   // 键为 Morton 编码；其他版本一律拒绝，重新打包即可
+
+struct ArchiveHeader
+{
+    char magic[4];
+    quint32 version;
+    quint32 count;         // 瓦片数量
+    quint32 reserved;
+    quint64 indexOffset;   // 索引偏移（8 字节对齐）
+    quint64 dataOffset;    // 数据区偏移
+};
+static_assert(sizeof(ArchiveHeader) == 32, "archive header must be 32 bytes");
+}   // namespace
+
+MapTileArchive::~MapTileArchive()
+{
+    close();
+}
+
+/**
+ * @brief             打开并映射瓦片包，校验文件头与索引范围
+ * @param archivePath 瓦片包路径
+ * @return            成功返回 true
+ */
+bool MapTileArchive::open(const QString& archivePath)
+{
+    close();
+
+    m_file.setFileName(archivePath);
+    if (!m_file.open(QIODevice::ReadOnly))
+        return false;
+
+    m_size = m_file.size();
+    if (m_size < qint64(sizeof(ArchiveHeader)))
+    {
+        close();
+        return false;
+    }
+
+    m_map = m_file.map(0, m_size);
+    if (!m_map)
+    {
+        qWarning() << "Failed to map tile archive" << archivePath;
+        close();
+        return false;
+    }
+
+    ArchiveHeader header;
+    std::memcpy(&header, m_map, sizeof(header));
+
+    const quint64 indexEnd = header.indexOffset + quint64(header.count) * sizeof(Entry);
+    if (std::memcmp(header.magic, ARCHIVE_MAGIC, 4) != 0 ||
+        header.version != ARCHIVE_VERSION ||
+        header.indexOffset % alignof(Entry) != 0 ||
+        indexEnd > quint64(m_size))
+    {
+        qWarning() << "Invalid tile archive" << archivePath;
+        close();
+        return false;
+    }
+
+    m_count = header.count;
+    m_index = reinterpret_cast<const Entry*>(m_map + header.indexOffset);
+    return true;
+}
+
+void MapTileArchive::close()
+{
+    if (m_map)
+        m_file.unmap(const_cast<uchar*>(m_map));
+    if (m_file.isOpen())
+        m_file.close();
+
+    m_map   = nullptr;
+    m_size  = 0;
+    m_index = nullptr;
+    m_count = 0;
+}
+
+QList<int> MapTileArchive::levels() const
+{
+    QList<int> list;
+    for (quint32 i = 0; i < m_count; ++i)
+    {
+        const int z = MapTileKey::level(m_index[i].key);
+        if (list.isEmpty() || list.last() != z)
+            list.append(z);
+    }
+    return list;
+}
+
+QList<QPoint> MapTileArchive::tiles(int z) const
+{
+    QList<QPoint> list;
+    if (!isOpen())
+        return list;
+
+    // 索引按 key 升序，同一级别的条目连续
+    const Entry* begin = m_index;
+    const Entry* end   = m_index + m_count;
+    const Entry* lo = std::lower_bound(begin, end, MapTileKey::encode(z, 0, 0),
+                                       [](const Entry& e, quint64 k) { return e.key < k; });
+    for (const Entry* e = lo; e != end; ++e)
+    {
+        if (MapTileKey::level(e->key) != z)
+            break;
+        list.append(QPoint(MapTileKey::tileX(e->key), MapTileKey::tileY(e->key)));
+    }
+    return list;
+}
+
+const MapTileArchive::Entry* MapTileArchive::find(const TileKey& key) const
+{
+    if (!isOpen())
+        return nullptr;
+
+    const quint64 k = key.code();
+    const Entry* end = m_index + m_count;
+    const Entry* e = std::lower_bound(m_index, end, k,
+                                      [](const Entry& a, quint64 b) { return a.key < b; });
+    return (e != end && e->key == k) ? e : nullptr;
+}
+
+QByteArray MapTileArchive::tileData(const TileKey& key) const
+{
+    const Entry* e = find(key);
+    if (!e || e->offset + e->length > quint64(m_size))
+        return QByteArray();
+
+    return QByteArray::fromRawData(reinterpret_cast<const char*>(m_map + e->offset), int(e->length));
+}
+
+/**
+ * @brief             把 mapRoot/z/x/y.jpg 目录结构打包成单文件瓦片包；
+ *                    输出路径已有瓦片包时，目录中没有的瓦片从旧包中保留（用于向包中追加级别）
+ * @param mapRootPath 离线地图根目录
+ * @param archivePath 输出路径（一般为 mapRoot/tiles.lxpack）
+ * @param error       失败原因（可为空）
+ * @return            成功返回 true；有瓦片文件读不到或为空时失败（error 中给出路径），原有瓦片包不变
+ */
+bool MapTileArchive::pack(const QString& mapRootPath, const QString& archivePath, QString* error)
+{
+    auto fail = [error](const QString& msg) {
+        if (error)
+            *error = msg;
+        return false;
+    };
+
+    // 1) 收集瓦片（借用瓦片目录的扫描结果）
+    MapTileCatalog catalog;
+    catalog.loadOrScan(mapRootPath);
+
+    struct Source { quint64 key; QString path; };   // key 为 Morton 编码；path 为空表示取自旧包
+    QVector<Source> sources;
+    for (int z : catalog.levels())
+    {
+        for (const QPoint& t : catalog.tiles(z))
+        {
+            sources.append({MapTileKey::encode(z, t.x(), t.y()),
+                            mapRootPath + QString("/%1/%2/%3.jpg").arg(z).arg(t.x()).arg(t.y())});
+        }
+    }
+
+    MapTileArchive old;
+    if (old.open(archivePath))
+    {
+        for (quint32 i = 0; i < old.m_count; ++i)
+        {
+            const TileKey t = TileKey::fromCode(old.m_index[i].key);
+            if (!catalog.contains(t.z, t.x, t.y))
+                sources.append({old.m_index[i].key, QString()});
+        }
+    }
+
+    if (sources.isEmpty())
+        return fail("no tiles found in " + mapRootPath);
+
+    std::sort(sources.begin(), sources.end(),
+              [](const Source& a, const Source& b) { return a.key < b.key; });
+
+    // 写临时文件，成功后再替换（旧包在写完之前仍要读取）
+    QSaveFile out(archivePath);
+    if (!out.open(QIODevice::WriteOnly))
+        return fail("cannot write " + archivePath);
+
+    ArchiveHeader header;
+    std::memcpy(header.magic, ARCHIVE_MAGIC, 4);
+    header.version     = ARCHIVE_VERSION;
+    header.count       = quint32(sources.size());
+    header.reserved    = 0;
+    header.indexOffset = sizeof(ArchiveHeader);
+    header.dataOffset  = header.indexOffset + quint64(sources.size()) * sizeof(Entry);
+
+    // 2) 先写数据区，边写边填索引
+    QVector<Entry> index(sources.size());
+    if (!out.seek(qint64(header.dataOffset)))
+        return fail("seek failed in " + archivePath);
+
+    quint64 offset = header.dataOffset;
+    for (int i = 0; i < sources.size(); ++i)
+    {
+        // 读不到的瓦片不能记成长度 0 的条目，否则目录认为它存在，既加载不出来也不会重新生成
+        QByteArray bytes;
+        if (sources[i].path.isEmpty())
+        {
+            const TileKey t = TileKey::fromCode(sources[i].key);
+            bytes = old.tileData(t);
+            if (bytes.isEmpty())
+                return fail(QString("tile %1/%2/%3 is empty in %4").arg(t.z).arg(t.x).arg(t.y).arg(archivePath));
+        }
+        else
+        {
+            QFile in(sources[i].path);
+            if (!in.open(QIODevice::ReadOnly))
+                return fail("cannot read " + sources[i].path);
+            bytes = in.readAll();
+            if (bytes.isEmpty())
+                return fail("empty tile " + sources[i].path);
+        }
+
+        if (out.write(bytes) != bytes.size())
+            return fail("write failed in " + archivePath);
+
+        index[i].key      = sources[i].key;
+        index[i].offset   = offset;
+        index[i].length   = quint32(bytes.size());
+        index[i].reserved = 0;
+        offset += quint64(bytes.size());
+    }
+
+    // 3) 回填文件头和索引
+    if (!out.seek(0) ||
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header)) != qint64(sizeof(header)) ||
+        out.write(reinterpret_cast<const char*>(index.constData()), qint64(index.size()) * qint64(sizeof(Entry)))
+            != qint64(index.size()) * qint64(sizeof(Entry)))
+    {
+        return fail("write failed in " + archivePath);
+    }
+
+    old.close();   // Windows 下映射中的文件不能被替换
+    if (!out.commit())
+        return fail("cannot replace " + archivePath);
+    return true;
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "mapgraphicsview_global.h"
+#include "mapStruct.h"
+#include <QByteArray>
+#include <QFile>
+#include <QList>
+#include <QPoint>
+
+// 单文件瓦片包（内存映射读取）：
+//   [文件头 32B][索引：按瓦片编码升序的定长条目][瓦片数据（原始 JPEG 字节）]
+// 瓦片编码为 64 位 Morton 编码（TileKey::code，级别优先、级内 Z 序），
+// 只接受当前版本，其他版本的文件打开失败。
+// 打开后整个文件映射进内存，按索引二分查找，瓦片数据直接在映射区上解码，
+// 不需要每块瓦片一次 open()。所有数值按小端存储。
+class MAPGRAPHICSVIEW_EXPORT MapTileArchive
+{
+public:
+    MapTileArchive() = default;
+    ~MapTileArchive();
+
+    static QString defaultFileName() { return QStringLiteral("tiles.lxpack"); }
+
+    bool open(const QString& archivePath);
+    void close();
+    bool isOpen() const { return m_index != nullptr; }
+
+    int tileCount() const { return int(m_count); }
+    QList<int> levels() const;           // 包中存在的级别（升序）
+    QList<QPoint> tiles(int z) const;    // 某级别的全部瓦片编号（按 Morton 编码即 Z 序，不是按 (x, y)）
+    bool contains(const TileKey& key) const { return find(key) != nullptr; }
+
+    // 瓦片原始字节：直接引用映射区，不拷贝（归档关闭前有效），可在多线程中并发调用
+    QByteArray tileData(const TileKey& key) const;
+
+    // 把目录结构 mapRoot/z/x/y.jpg 打包成单文件
+    static bool pack(const QString& mapRootPath, const QString& archivePath, QString* error = nullptr);
+
+private:
+    struct Entry
+    {
+        quint64 key;      // TileKey::code()，升序
+        quint64 offset;   // 数据在文件中的偏移
+        quint32 length;   // 数据长度
+        quint32 reserved;
+    };
+
+    const Entry* find(const TileKey& key) const;
+
+private:
+    Q_DISABLE_COPY(MapTileArchive)
+
+    QFile m_file;
+    const uchar* m_map = nullptr;
+    qint64 m_size = 0;
+    const Entry* m_index = nullptr;
+    quint32 m_count = 0;
+};
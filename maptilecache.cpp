@@ -0,0 +1,157 @@
+#include "maptilecache.h"
+
+MapTileCache::MapTileCache(qint64 decodedBudget, qint64 compressedBudget)
+{
+    m_decoded.budget    = decodedBudget;
+    m_compressed.budget = compressedBudget;
+}
+
+/**
+ * @brief                  设置两层缓存的字节预算，超出部分立即淘汰
+ * @param decodedBudget    热层（解码后图像）预算
+ * @param compressedBudget 冷层（原始字节）预算
+ */
+void MapTileCache::setBudget(qint64 decodedBudget, qint64 compressedBudget)
+{
+    m_decoded.budget    = qMax<qint64>(0, decodedBudget);
+    m_compressed.budget = qMax<qint64>(0, compressedBudget);
+
+    trim(m_decoded, m_stats.decodedEvictions);
+    trim(m_compressed, m_stats.compressedEvictions);
+}
+
+bool MapTileCache::findDecoded(const TileKey& key, QPixmap& pix)
+{
+    if (!touch(m_decoded, key.code(), pix))
+        return false;
+
+    ++m_stats.decodedHits;
+    return true;
+}
+
+bool MapTileCache::peekDecoded(const TileKey& key, QPixmap& pix) const
+{
+    auto it = m_decoded.index.constFind(key.code());
+    if (it == m_decoded.index.constEnd())
+        return false;
+
+    pix = it->value;
+    return true;
+}
+
+bool MapTileCache::peekCompressed(const TileKey& key, QByteArray& bytes) const
+{
+    auto it = m_compressed.index.constFind(key.code());
+    if (it == m_compressed.index.constEnd())
+        return false;
+
+    bytes = it->value;
+    return true;
+}
+
+bool MapTileCache::findCompressed(const TileKey& key, QByteArray& bytes)
+{
+    if (!touch(m_compressed, key.code(), bytes))
+        return false;
+
+    ++m_stats.compressedHits;
+    return true;
+}
+
+void MapTileCache::insertDecoded(const TileKey& key, const QPixmap& pix)
+{
+    if (pix.isNull())
+        return;
+    insert(m_decoded, key.code(), pix, costOf(pix), m_stats.decodedEvictions);
+}
+
+void MapTileCache::insertCompressed(const TileKey& key, const QByteArray& bytes)
+{
+    if (bytes.isEmpty())
+        return;
+    insert(m_compressed, key.code(), bytes, bytes.size(), m_stats.compressedEvictions);
+}
+
+void MapTileCache::clear()
+{
+    m_decoded.index.clear();
+    m_decoded.lru.clear();
+    m_decoded.bytes = 0;
+
+    m_compressed.index.clear();
+    m_compressed.lru.clear();
+    m_compressed.bytes = 0;
+}
+
+void MapTileCache::resetCounters()
+{
+    m_stats = MapTileCacheStats();
+}
+
+MapTileCacheStats MapTileCache::stats() const
+{
+    MapTileCacheStats s = m_stats;
+    s.decodedBytes    = m_decoded.bytes;
+    s.compressedBytes = m_compressed.bytes;
+    s.decodedCount    = m_decoded.index.size();
+    s.compressedCount = m_compressed.index.size();
+    return s;
+}
+
+template <typename T>
+bool MapTileCache::touch(Tier<T>& tier, quint64 key, T& out)
+{
+    auto it = tier.index.find(key);
+    if (it == tier.index.end())
+        return false;
+
+    // 移到 LRU 头部（splice 不会使迭代器失效）
+    tier.lru.splice(tier.lru.begin(), tier.lru, it->lru);
+    out = it->value;
+    return true;
+}
+
+template <typename T>
+void MapTileCache::insert(Tier<T>& tier, quint64 key, const T& value, qint64 cost, quint64& evictions)
+{
+    auto it = tier.index.find(key);
+    if (it != tier.index.end())
+    {
+        tier.bytes -= it->cost;
+        it->value = value;
+        it->cost  = cost;
+        tier.lru.splice(tier.lru.begin(), tier.lru, it->lru);
+    }
+    else
+    {
+        tier.lru.push_front(key);
+
+        typename Tier<T>::Entry e;
+        e.value = value;
+        e.cost  = cost;
+        e.lru   = tier.lru.begin();
+        tier.index.insert(key, e);
+    }
+    tier.bytes += cost;
+
+    trim(tier, evictions);
+}
+
+template <typename T>
+void MapTileCache::trim(Tier<T>& tier, quint64& evictions)
+{
+    while (tier.bytes > tier.budget && !tier.lru.empty())
+    {
+        const quint64 oldest = tier.lru.back();
+        tier.lru.pop_back();
+
+        tier.bytes -= tier.index.value(oldest).cost;
+        tier.index.remove(oldest);
+        ++evictions;
+    }
+}
+
+qint64 MapTileCache::costOf(const QPixmap& pix)
+{
+    return qint64(pix.width()) * pix.height() * qMax(1, pix.depth() / 8);
+}
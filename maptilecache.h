@@ -0,0 +1,88 @@
+#pragma once
+#include "mapgraphicsview_global.h"
+#include "mapStruct.h"
+#include <QByteArray>
+#include <QHash>
+#include <QPixmap>
+#include <list>
+
+// 瓦片缓存统计（用于评估内存预算）
+struct MapTileCacheStats
+{
+    quint64 decodedHits    = 0;   // 热层命中（无需解码）
+    quint64 compressedHits = 0;   // 冷层命中（需解码，不读盘）
+    quint64 misses         = 0;   // 两层都未命中（需读盘）
+    quint64 decodedEvictions    = 0;
+    quint64 compressedEvictions = 0;
+
+    qint64 decodedBytes    = 0;   // 热层当前占用
+    qint64 compressedBytes = 0;   // 冷层当前占用
+    int decodedCount    = 0;
+    int compressedCount = 0;
+};
+
+// 两级瓦片缓存（仅在主线程使用）：
+//   热层：解码后的 QPixmap，与场景图元共享同一份数据，LRU 淘汰
+//   冷层：原始 JPEG 字节，重新显示只需解码、不需读盘，LRU 淘汰
+// 两层各自有字节预算，插入时立即淘汰到预算以内
+class MAPGRAPHICSVIEW_EXPORT MapTileCache
+{
+public:
+    MapTileCache(qint64 decodedBudget = 192ll * 1024 * 1024,
+                 qint64 compressedBudget = 64ll * 1024 * 1024);
+
+    void setBudget(qint64 decodedBudget, qint64 compressedBudget);
+    qint64 decodedBudget() const { return m_decoded.budget; }
+    qint64 compressedBudget() const { return m_compressed.budget; }
+
+    // 查找解码层，命中时刷新 LRU 并返回 true
+    bool findDecoded(const TileKey& key, QPixmap& pix);
+    // 查找压缩层，命中时刷新 LRU 并返回 true
+    bool findCompressed(const TileKey& key, QByteArray& bytes);
+    // 两层都未命中时调用，只用于统计
+    void recordMiss() { ++m_stats.misses; }
+
+    void insertDecoded(const TileKey& key, const QPixmap& pix);
+    void insertCompressed(const TileKey& key, const QByteArray& bytes);
+
+    bool containsDecoded(const TileKey& key) const { return m_decoded.index.contains(key.code()); }
+    // 只读查找热层：不刷新 LRU、不计入统计（绘制时取替代瓦片用）
+    bool peekDecoded(const TileKey& key, QPixmap& pix) const;
+    // 只读查找冷层：不刷新 LRU、不计入统计（预取用，预取不算缓存访问）
+    bool peekCompressed(const TileKey& key, QByteArray& bytes) const;
+
+    void clear();
+    void resetCounters();
+    MapTileCacheStats stats() const;
+
+private:
+    template <typename T>
+    struct Tier
+    {
+        struct Entry
+        {
+            T value;
+            qint64 cost = 0;
+            typename std::list<quint64>::iterator lru;
+        };
+
+        QHash<quint64, Entry> index;   // 键为 TileKey::code()
+        std::list<quint64> lru;        // 头部最新，尾部最旧
+        qint64 bytes  = 0;
+        qint64 budget = 0;
+    };
+
+    template <typename T>
+    static bool touch(Tier<T>& tier, quint64 key, T& out);
+    template <typename T>
+    static void insert(Tier<T>& tier, quint64 key, const T& value, qint64 cost, quint64& evictions);
+    template <typename T>
+    static void trim(Tier<T>& tier, quint64& evictions);
+
+    static qint64 costOf(const QPixmap& pix);
+
+private:
+    Tier<QPixmap> m_decoded;
+    Tier<QByteArray> m_compressed;
+    MapTileCacheStats m_stats;
+};
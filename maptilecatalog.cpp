@@ -0,0 +1,311 @@
+#include "maptilecatalog.h"
+
+#include "maptilearchive.h"
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <algorithm>
+
+namespace {
+constexpr quint32 CATALOG_MAGIC   = 0x4C585443;   // "LXTC"
+constexpr quint32 CATALOG_VERSION = 1;
+
+qint64 mtimeOf(const QString& path)
+{
+    return QFileInfo(path).lastModified().toMSecsSinceEpoch();
+}
+
+// 目录下的数字子目录名 / 数字文件名（不含扩展名），升序
+QVector<int> numericEntries(const QString& path, QDir::Filters filter)
+{
+    QVector<int> values;
+    QDir dir(path);
+    dir.setFilter(filter | QDir::NoDotAndDotDot);
+    for (const QString& name : dir.entryList())
+    {
+        bool ok;
+        int v = QFileInfo(name).baseName().toInt(&ok);
+        if (ok)
+            values.append(v);
+    }
+    std::sort(values.begin(), values.end());
+    return values;
+}
+}   // namespace
+
+/**
+ * @brief            追加一列：把升序的 y 压缩成连续区间
+ * @param x          列号
+ * @param colMtime   列目录修改时间
+ * @param sortedYs   升序 y 列表
+ */
+void MapTileCatalog::Level::appendColumn(int x, qint64 colMtime, const QVector<int>& sortedYs)
+{
+    if (sortedYs.isEmpty())
+        return;
+
+    Column col;
+    col.x        = x;
+    col.firstRun = runs.size();
+    col.mtime    = colMtime;
+    columns.append(col);
+
+    for (int y : sortedYs)
+    {
+        if (col.firstRun < runs.size() && runs.last().y + runs.last().len == y)
+            ++runs.last().len;
+        else if (col.firstRun == runs.size() || runs.last().y + runs.last().len < y)
+            runs.append({y, 1});
+        else
+            continue;   // 重复的 y
+        ++count;
+    }
+
+    const QRect colRect(QPoint(x, sortedYs.first()), QPoint(x, sortedYs.last()));
+    bounds = bounds.isNull() ? colRect : bounds.united(colRect);
+}
+
+/**
+ * @brief             读取持久化目录，按修改时间校验，过期级别重新扫描
+ * @param mapRootPath 离线地图根目录
+ * @return            至少有一个级别返回 true
+ */
+bool MapTileCatalog::loadOrScan(const QString& mapRootPath)
+{
+    m_levels.clear();
+
+    const QString catalogPath = mapRootPath + "/" + defaultFileName();
+    const QVector<Level> persisted = load(catalogPath);
+
+    bool dirty = false;
+    for (int z : numericEntries(mapRootPath, QDir::Dirs))
+    {
+        if (z < 1 || z > 23)
+            continue;
+
+        const QString levelPath = mapRootPath + QString("/%1").arg(z);
+        auto it = std::find_if(persisted.cbegin(), persisted.cend(),
+                               [z](const Level& l) { return l.z == z; });
+        if (it != persisted.cend() && isFresh(*it, levelPath))
+        {
+            m_levels.append(*it);
+        }
+        else
+        {
+            Level level = scanLevel(z, levelPath);
+            if (level.count > 0)
+                m_levels.append(level);
+            dirty = true;
+        }
+    }
+
+    // 有级别被删掉也需要回写
+    if (dirty || persisted.size() != m_levels.size())
+        save(catalogPath);
+
+    return !m_levels.isEmpty();
+}
+
+void MapTileCatalog::buildFromArchive(const MapTileArchive& archive)
+{
+    m_levels.clear();
+
+    for (int z : archive.levels())
+    {
+        Level level;
+        level.z = z;
+
+        // 瓦片包索引按 Morton 编码（Z 序）排列，同一列不连续：先按 (x, y) 排序再分列
+        QList<QPoint> tiles = archive.tiles(z);
+        std::sort(tiles.begin(), tiles.end(), [](const QPoint& a, const QPoint& b) {
+            return a.x() != b.x() ? a.x() < b.x() : a.y() < b.y();
+        });
+        QVector<int> ys;
+        for (int i = 0; i < tiles.size(); ++i)
+        {
+            ys.append(tiles[i].y());
+            if (i + 1 == tiles.size() || tiles[i + 1].x() != tiles[i].x())
+            {
+                level.appendColumn(tiles[i].x(), 0, ys);
+                ys.clear();
+            }
+        }
+
+        if (level.count > 0)
+            m_levels.append(level);
+    }
+}
+
+QList<int> MapTileCatalog::levels() const
+{
+    QList<int> list;
+    for (const Level& l : m_levels)
+        list.append(l.z);
+    return list;
+}
+
+const MapTileCatalog::Level* MapTileCatalog::findLevel(int z) const
+{
+    for (const Level& l : m_levels)
+    {
+        if (l.z == z)
+            return &l;
+    }
+    return nullptr;
+}
+
+/**
+ * @brief   查询瓦片是否存在：列二分 + 区间二分
+ */
+bool MapTileCatalog::contains(int z, int x, int y) const
+{
+    const Level* level = findLevel(z);
+    if (!level || !level->bounds.contains(x, y))
+        return false;
+
+    auto col = std::lower_bound(level->columns.cbegin(), level->columns.cend(), x,
+                                [](const Column& c, int v) { return c.x < v; });
+    if (col == level->columns.cend() || col->x != x)
+        return false;
+
+    const int colIndex = int(col - level->columns.cbegin());
+    auto first = level->runs.cbegin() + col->firstRun;
+    auto last  = level->runs.cbegin() + level->runEnd(colIndex);
+
+    // 第一个起点 > y 的区间的前一个
+    auto run = std::upper_bound(first, last, y, [](int v, const Run& r) { return v < r.y; });
+    if (run == first)
+        return false;
+    --run;
+    return y < run->y + run->len;
+}
+
+QRect MapTileCatalog::tileBounds(int z) const
+{
+    const Level* level = findLevel(z);
+    return level ? level->bounds : QRect();
+}
+
+int MapTileCatalog::tileCount(int z) const
+{
+    const Level* level = findLevel(z);
+    return level ? level->count : 0;
+}
+
+QList<QPoint> MapTileCatalog::tiles(int z) const
+{
+    QList<QPoint> list;
+    const Level* level = findLevel(z);
+    if (!level)
+        return list;
+
+    list.reserve(level->count);
+    for (int c = 0; c < level->columns.size(); ++c)
+    {
+        for (int r = level->columns[c].firstRun; r < level->runEnd(c); ++r)
+        {
+            for (int i = 0; i < level->runs[r].len; ++i)
+                list.append(QPoint(level->columns[c].x, level->runs[r].y + i));
+        }
+    }
+    return list;
+}
+
+MapTileCatalog::Level MapTileCatalog::scanLevel(int z, const QString& levelPath)
+{
+    Level level;
+    level.z     = z;
+    level.mtime = mtimeOf(levelPath);
+
+    for (int x : numericEntries(levelPath, QDir::Dirs))
+    {
+        const QString xPath = levelPath + QString("/%1").arg(x);
+        level.appendColumn(x, mtimeOf(xPath), numericEntries(xPath, QDir::Files));
+    }
+    return level;
+}
+
+/**
+ * @brief 级别目录与每个列目录的修改时间都没变，说明瓦片没有增删
+ */
+bool MapTileCatalog::isFresh(const Level& level, const QString& levelPath)
+{
+    if (level.mtime != mtimeOf(levelPath))
+        return false;
+
+    for (const Column& c : level.columns)
+    {
+        if (c.mtime != mtimeOf(levelPath + QString("/%1").arg(c.x)))
+            return false;
+    }
+    return true;
+}
+
+bool MapTileCatalog::save(const QString& catalogPath) const
+{
+    QSaveFile file(catalogPath);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_15);
+    out << CATALOG_MAGIC << CATALOG_VERSION << qint32(m_levels.size());
+
+    for (const Level& l : m_levels)
+    {
+        out << qint32(l.z) << l.mtime << qint32(l.count) << l.bounds
+            << qint32(l.columns.size()) << qint32(l.runs.size());
+        for (const Column& c : l.columns)
+            out << c.x << c.firstRun << c.mtime;
+        for (const Run& r : l.runs)
+            out << r.y << r.len;
+    }
+
+    return out.status() == QDataStream::Ok && file.commit();
+}
+
+QVector<MapTileCatalog::Level> MapTileCatalog::load(const QString& catalogPath)
+{
+    QVector<Level> levels;
+
+    QFile file(catalogPath);
+    if (!file.open(QIODevice::ReadOnly))
+        return levels;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_15);
+
+    quint32 magic = 0, version = 0;
+    qint32 levelCount = 0;
+    in >> magic >> version >> levelCount;
+    if (magic != CATALOG_MAGIC || version != CATALOG_VERSION || levelCount < 0)
+        return levels;
+
+    for (qint32 i = 0; i < levelCount && in.status() == QDataStream::Ok; ++i)
+    {
+        Level l;
+        qint32 z = 0, count = 0, colCount = 0, runCount = 0;
+        in >> z >> l.mtime >> count >> l.bounds >> colCount >> runCount;
+        if (colCount < 0 || runCount < 0)
+            return QVector<Level>();
+
+        l.z     = z;
+        l.count = count;
+        l.columns.resize(colCount);
+        for (Column& c : l.columns)
+            in >> c.x >> c.firstRun >> c.mtime;
+        l.runs.resize(runCount);
+        for (Run& r : l.runs)
+            in >> r.y >> r.len;
+
+        levels.append(l);
+    }
+
+    // 文件损坏时整个丢弃，重新扫描
+    if (in.status() != QDataStream::Ok)
+        return QVector<Level>();
+    return levels;
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include "mapgraphicsview_global.h"
+#include <QList>
+#include <QPoint>
+#include <QRect>
+#include <QString>
+#include <QVector>
+
+class MapTileArchive;
+
+// 瓦片目录（哪些瓦片存在于磁盘/瓦片包中）：
+//   每个级别按列（x）存放，列内的 y 压缩成连续区间 [y, y+len)，每块瓦片只占几个字节。
+//   目录结构的扫描结果持久化到 mapRoot/tiles.lxcat，下次启动只需比对目录修改时间，
+//   只有修改过的级别才重新扫描。
+class MAPGRAPHICSVIEW_EXPORT MapTileCatalog
+{
+public:
+    static QString defaultFileName() { return QStringLiteral("tiles.lxcat"); }
+
+    // 读取持久化目录并按目录修改时间校验，过期的级别重新扫描后回写
+    bool loadOrScan(const QString& mapRootPath);
+    // 直接从瓦片包索引构建（瓦片包本身就是目录，无需持久化）
+    void buildFromArchive(const MapTileArchive& archive);
+    void clear() { m_levels.clear(); }
+
+    bool isEmpty() const { return m_levels.isEmpty(); }
+    QList<int> levels() const;                // 已有级别（升序）
+    bool hasLevel(int z) const { return findLevel(z) != nullptr; }
+    bool contains(int z, int x, int y) const;
+    QRect tileBounds(int z) const;            // 该级别瓦片编号的包围范围（闭区间）
+    int tileCount(int z) const;
+    QList<QPoint> tiles(int z) const;         // 展开为瓦片编号列表（只在需要时使用）
+
+    bool save(const QString& catalogPath) const;
+
+private:
+    struct Run
+    {
+        qint32 y   = 0;   // 起始 y
+        qint32 len = 0;   // 连续瓦片数
+    };
+
+    struct Column
+    {
+        qint32 x        = 0;
+        qint32 firstRun = 0;   // 本列第一个区间在 runs 中的下标
+        qint64 mtime    = 0;   // 列目录修改时间（瓦片包为 0）
+    };
+
+    struct Level
+    {
+        int z = 0;
+        qint64 mtime = 0;          // 级别目录修改时间（瓦片包为 0）
+        int count = 0;
+        QRect bounds;
+        QVector<Column> columns;   // 按 x 升序
+        QVector<Run> runs;         // 按列连续存放，列内按 y 升序
+
+        int runEnd(int col) const  // 第 col 列区间的结束下标
+        {
+            return col + 1 < columns.size() ? columns[col + 1].firstRun : runs.size();
+        }
+        void appendColumn(int x, qint64 mtime, const QVector<int>& sortedYs);
+    };
+
+    const Level* findLevel(int z) const;
+    static Level scanLevel(int z, const QString& levelPath);
+    static bool isFresh(const Level& level, const QString& levelPath);
+    static QVector<Level> load(const QString& catalogPath);
+
+private:
+    QVector<Level> m_levels;   // 按 z 升序
+};
@@ -0,0 +1,130 @@
+#pragma once
+#include <QByteArray>
+#include <QString>
+#include <QtGlobal>
+
+// 只认 __BMI2__：AVX2 不蕴含 BMI2，且 Zen 3 之前的 AMD 上 pdep/pext 为微码实现，远慢于移位掩码
+#if defined(__BMI2__)
+#include <immintrin.h>
+#define LX_HAVE_BMI2 1
+#endif
+
+// 64 位瓦片编码（Morton / Z 序）：
+//   [63..58] 级别 z，[57..0] x、y 按位交错（x 占偶数位，y 占奇数位，各 29 位）。
+//   交错后从高到低每 2 位正好是一位 QuadKey 数字（x 位 + 2 × y 位），
+//   按编码排序即"级别优先、级内 Z 序"，父子瓦片只差移位，哈希/比较只涉及一个整数。
+namespace MapTileKey
+{
+constexpr int     LEVEL_SHIFT = 58;
+constexpr int     MAX_LEVEL   = 29;
+constexpr quint64 MORTON_MASK = (quint64(1) << LEVEL_SHIFT) - 1;
+constexpr quint64 INVALID     = ~quint64(0);
+
+namespace detail {
+inline quint64 spread(quint32 v)   // 低 32 位分散到偶数位
+{
+    quint64 x = v;
+    x = (x | (x << 16)) & 0x0000FFFF0000FFFFull;
+    x = (x | (x << 8))  & 0x00FF00FF00FF00FFull;
+    x = (x | (x << 4))  & 0x0F0F0F0F0F0F0F0Full;
+    x = (x | (x << 2))  & 0x3333333333333333ull;
+    x = (x | (x << 1))  & 0x5555555555555555ull;
+    return x;
+}
+
+inline quint32 compact(quint64 x)   // spread 的逆运算
+{
+    x &= 0x5555555555555555ull;
+    x = (x | (x >> 1))  & 0x3333333333333333ull;
+    x = (x | (x >> 2))  & 0x0F0F0F0F0F0F0F0Full;
+    x = (x | (x >> 4))  & 0x00FF00FF00FF00FFull;
+    x = (x | (x >> 8))  & 0x0000FFFF0000FFFFull;
+    x = (x | (x >> 16)) & 0x00000000FFFFFFFFull;
+    return quint32(x);
+}
+}   // namespace detail
+
+inline quint64 encode(int z, int x, int y)
+{
+#ifdef LX_HAVE_BMI2
+    const quint64 m = _pdep_u64(quint32(x), 0x5555555555555555ull) | _pdep_u64(quint32(y), 0xAAAAAAAAAAAAAAAAull);
+#else
+    const quint64 m = detail::spread(quint32(x)) | (detail::spread(quint32(y)) << 1);
+#endif
+    return (quint64(z) << LEVEL_SHIFT) | (m & MORTON_MASK);
+}
+
+inline int level(quint64 key) { return int(key >> LEVEL_SHIFT); }
+
+inline int tileX(quint64 key)
+{
+#ifdef LX_HAVE_BMI2
+    return int(_pext_u64(key & MORTON_MASK, 0x5555555555555555ull));
+#else
+    return int(detail::compact(key & MORTON_MASK));
+#endif
+}
+
+inline int tileY(quint64 key)
+{
+#ifdef LX_HAVE_BMI2
+    return int(_pext_u64(key & MORTON_MASK, 0xAAAAAAAAAAAAAAAAull));
+#else
+    return int(detail::compact((key & MORTON_MASK) >> 1));
+#endif
+}
+
+// ===== 层级导航 =====
+inline quint64 parent(quint64 key)   // 0 级没有父瓦片，返回 INVALID
+{
+    const int z = level(key);
+    return z > 0 ? (quint64(z - 1) << LEVEL_SHIFT) | ((key & MORTON_MASK) >> 2) : INVALID;
+}
+
+// quadrant：0 左上、1 右上、2 左下、3 右下（与 QuadKey 数字相同）
+inline quint64 child(quint64 key, int quadrant)
+{
+    const int z = level(key);
+    return z < MAX_LEVEL ? (quint64(z + 1) << LEVEL_SHIFT) | ((key & MORTON_MASK) << 2) | quint64(quadrant & 3)
+                         : INVALID;
+}
+
+// 同级相邻瓦片：x 方向按经度环绕，y 越界返回 INVALID
+inline quint64 neighbour(quint64 key, int dx, int dy)
+{
+    const int z = level(key);
+    const qint64 size = qint64(1) << z;
+    const qint64 y = qint64(tileY(key)) + dy;
+    if (y < 0 || y >= size)
+        return INVALID;
+    const qint64 x = ((qint64(tileX(key)) + dx) % size + size) % size;
+    return encode(z, int(x), int(y));
+}
+
+// ===== QuadKey 字符串（只在与外部交互时使用） =====
+inline QString toQuadKey(quint64 key)
+{
+    const int z = level(key);
+    QByteArray buf(z, '0');
+    for (int i = 0; i < z; ++i)
+        buf[i] = char('0' + ((key >> (2 * (z - 1 - i))) & 3));
+    return QString::fromLatin1(buf);
+}
+
+inline quint64 fromQuadKey(const QString& quadKey)   // 含非法字符或过长返回 INVALID
+{
+    const int z = quadKey.size();
+    if (z > MAX_LEVEL)
+        return INVALID;
+
+    quint64 m = 0;
+    for (QChar c : quadKey)
+    {
+        const int digit = c.unicode() - '0';
+        if (digit < 0 || digit > 3)
+            return INVALID;
+        m = (m << 2) | quint64(digit);
+    }
+    return (quint64(z) << LEVEL_SHIFT) | m;
+}
+}   // namespace MapTileKey
@@ -0,0 +1,243 @@
+#include "maptilelayeritem.h"
+
+#include "maptilemanager.h"
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <QWidget>
+#include <QtMath>
+
+namespace {
+constexpr int MAX_FALLBACK_LEVELS = 4;   // 最多向上找几级替代瓦片
+}
+
+MapTileLayerItem::MapTileLayerItem(MapTileManager* manager)
+    : m_manager(manager)
+{
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption, true);   // 需要 exposedRect
+    setZValue(0);   // 底层
+}
+
+void MapTileLayerItem::setWorldSize(qreal size)
+{
+    if (qFuzzyCompare(size, m_worldSize))
+        return;
+
+    prepareGeometryChange();
+    m_worldSize = size;
+    refresh();
+}
+
+void MapTileLayerItem::setShowTileBorders(bool show)
+{
+    if (show == m_showBorders)
+        return;
+
+    m_showBorders = show;
+    refresh();
+}
+
+void MapTileLayerItem::refresh(const QRectF& sceneRect)
+{
+    if (sceneRect.isNull())
+    {
+        m_bufferDirty = m_buffer.rect();
+        update();
+        return;
+    }
+
+    if (m_bufferScale > 0.0)
+    {
+        const qreal k = m_bufferScale * m_buffer.devicePixelRatio();
+        const QRectF dev((sceneRect.topLeft() - m_bufferOrigin) * k, sceneRect.size() * k);
+        m_bufferDirty += dev.toAlignedRect();
+    }
+    update(sceneRect);
+}
+
+QRectF MapTileLayerItem::boundingRect() const
+{
+    return QRectF(0, 0, m_worldSize, m_worldSize);
+}
+
+/**
+ * @brief          从后备缓冲贴出暴露区域；有旋转等非缩放变换时直接绘制瓦片
+ * @param painter
+ * @param option   exposedRect 为需要重绘的 scene 范围
+ * @param widget   viewport
+ */
+void MapTileLayerItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
+{
+    const QRectF exposed = option->exposedRect.intersected(boundingRect());
+    if (exposed.isEmpty())
+        return;
+
+    const QTransform t = painter->worldTransform();
+    if (!widget || t.type() > QTransform::TxScale || !qFuzzyCompare(t.m11(), t.m22()))
+    {
+        drawTiles(painter, exposed);
+        return;
+    }
+
+    updateBackbuffer(t, widget);
+
+    // 缓冲像素 q 显示在 viewport 物理像素 q + residual 处（residual 为不足一个物理像素的平移余量）
+    const qreal dpr = m_buffer.devicePixelRatio();
+    const QPointF residual = t.map(m_bufferOrigin) * dpr;
+    const QRect dev = t.mapRect(exposed).toAlignedRect().intersected(widget->rect());
+    painter->save();
+    painter->resetTransform();
+    painter->drawPixmap(QRectF(dev), m_buffer, QRectF(dev.topLeft() * dpr - residual, dev.size() * dpr));
+    painter->restore();
+}
+
+/**
+ * @brief        使后备缓冲与当前视图变换一致：
+ *               比例、尺寸或 DPR 变化时整块重画；平移时缓冲按整物理像素原地移位（QPixmap::scroll），
+ *               不足一个物理像素的余量记在缓冲原点里，小数 DPR（1.25、1.5）下同样只补画新露出的条带；
+ *               待重画区域按物理像素记录，最后只重画待重画区域
+ * @param t      scene → viewport 变换
+ * @param widget viewport
+ */
+void MapTileLayerItem::updateBackbuffer(const QTransform& t, QWidget* widget)
+{
+    const qreal dpr = widget->devicePixelRatioF();
+    const QSize physical = widget->size() * dpr;
+    const QRect full(QPoint(0, 0), physical);
+
+    if (m_buffer.size() != physical || !qFuzzyCompare(m_buffer.devicePixelRatio(), dpr) ||
+        !qFuzzyCompare(t.m11(), m_bufferScale))
+    {
+        if (m_buffer.size() != physical)
+            m_buffer = QPixmap(physical);
+        // 物理尺寸不变而 DPR 变化（如 1.0 → 1.25 同时窗口缩小）时也要更新，否则此后每帧都判定为变化而整块重画
+        m_buffer.setDevicePixelRatio(dpr);
+        m_bufferOrigin = t.inverted().map(QPointF(0, 0));
+        m_bufferDirty  = full;
+    }
+    else
+    {
+        // 缓冲原点在当前变换下落到的物理像素位置即为累计平移量：移位整数部分，余量留在原点里
+        const QPointF shift = t.map(m_bufferOrigin) * dpr;
+        const QPoint  n(qRound(shift.x()), qRound(shift.y()));
+
+        if (!n.isNull())
+        {
+            if (qAbs(n.x()) < physical.width() && qAbs(n.y()) < physical.height())
+            {
+                m_buffer.scroll(n.x(), n.y(), m_buffer.rect());
+                m_bufferDirty.translate(n);
+                m_bufferDirty += QRegion(full).subtracted(QRegion(full.translated(n)));
+                m_bufferDirty &= full;
+                m_bufferOrigin = t.inverted().map((shift - QPointF(n)) / dpr);
+            }
+            else
+            {
+                m_bufferOrigin = t.inverted().map(QPointF(0, 0));
+                m_bufferDirty  = full;
+            }
+        }
+    }
+
+    m_bufferScale = t.m11();
+
+    if (m_bufferDirty.isEmpty())
+        return;
+
+    // 缓冲逻辑坐标 = viewport 坐标减去余量
+    const QPointF o = t.map(m_bufferOrigin);
+    const QTransform toBuffer = t * QTransform::fromTranslate(-o.x(), -o.y());
+    const QRectF bounds = m_bufferDirty.boundingRect();
+    const QRectF dirty(bounds.topLeft() / dpr, bounds.size() / dpr);
+
+    // 只重画待重画区域（底色取 viewport 背景，缓冲保持不透明，贴图时不做混合）
+    QPainter bp(&m_buffer);
+    bp.setTransform(QTransform::fromScale(1.0 / dpr, 1.0 / dpr));   // 裁剪区域按物理像素给出
+    bp.setClipRegion(m_bufferDirty);
+    bp.fillRect(m_bufferDirty.boundingRect(), widget->palette().brush(widget->backgroundRole()));
+    bp.setTransform(toBuffer);
+    drawTiles(&bp, toBuffer.inverted().mapRect(dirty).intersected(boundingRect()));
+    m_bufferDirty = QRegion();
+}
+
+/**
+ * @brief          只绘制 exposed 范围内的当前级别瓦片
+ * @param painter
+ * @param exposed  scene 范围
+ */
+void MapTileLayerItem::drawTiles(QPainter* painter, const QRectF& exposed) const
+{
+    if (exposed.isEmpty())
+        return;
+
+    const int z = m_manager->level();
+    const double span = m_manager->tileSpan(z);
+
+    const int x0 = qFloor(exposed.left()   / span);
+    const int y0 = qFloor(exposed.top()    / span);
+    const int x1 = qFloor(exposed.right()  / span);
+    const int y1 = qFloor(exposed.bottom() / span);
+
+    QPen borderPen(QColor(255, 0, 0, 120));   // 半透明红色
+    borderPen.setWidth(1);
+
+    for (int x = x0; x <= x1; ++x)
+    {
+        for (int y = y0; y <= y1; ++y)
+        {
+            const QRectF target(x * span, y * span, span, span);
+
+            QPixmap pix;
+            if (m_manager->residentTile(TileKey(z, x, y), pix))
+                painter->drawPixmap(target, pix, QRectF(0, 0, pix.width(), pix.height()));
+            else if (!drawFallback(painter, z, x, y, target))
+                continue;
+
+            if (m_showBorders)
+            {
+                painter->setPen(borderPen);
+                painter->setBrush(Qt::NoBrush);
+                painter->drawRect(target);
+            }
+        }
+    }
+}
+
+/**
+ * @brief         当前级别瓦片未就绪时，用缓存中的上级瓦片（裁出对应四分之一…）或下级四块瓦片填充
+ * @return        画了任何内容返回 true
+ */
+bool MapTileLayerItem::drawFallback(QPainter* painter, int z, int x, int y, const QRectF& target) const
+{
+    const MapTileCache& cache = m_manager->cache();
+
+    // 1) 上级瓦片：取其中对应的子区域
+    for (int d = 1; d <= MAX_FALLBACK_LEVELS && z - d >= 1; ++d)
+    {
+        QPixmap pix;
+        if (!cache.peekDecoded(TileKey(z - d, x >> d, y >> d), pix))
+            continue;
+
+        const int n = 1 << d;
+        const double sub = double(pix.width()) / n;
+        const QRectF source((x & (n - 1)) * sub, (y & (n - 1)) * sub, sub, sub);
+        painter->drawPixmap(target, pix, source);
+        return true;
+    }
+
+    // 2) 下级四块瓦片（缩小时常见）
+    bool drawn = false;
+    const QSizeF half = target.size() / 2;
+    for (int i = 0; i < 4; ++i)
+    {
+        QPixmap pix;
+        const int cx = 2 * x + (i & 1);
+        const int cy = 2 * y + (i >> 1);
+        if (!cache.peekDecoded(TileKey(z + 1, cx, cy), pix))
+            continue;
+
+        const QRectF quarter(target.topLeft() + QPointF((i & 1) * half.width(), (i >> 1) * half.height()), half);
+        painter->drawPixmap(quarter, pix, QRectF(0, 0, pix.width(), pix.height()));
+        drawn = true;
+    }
+    return drawn;
+}
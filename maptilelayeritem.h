@@ -0,0 +1,46 @@
+#pragma once
+#include "mapgraphicsview_global.h"
+#include <QGraphicsItem>
+#include <QPixmap>
+#include <QRegion>
+
+class MapTileManager;
+
+// 底图瓦片图层：整个底图只有这一个场景图元，paint() 只绘制与暴露区域相交的瓦片，
+// 像素直接取自瓦片管理器/瓦片缓存。当前级别缺瓦片时用缓存中的上级/下级瓦片临时填充。
+// 底图先合成到与 viewport 等大的后备缓冲：纯平移时缓冲按整物理像素移位，只补画新露出的条带，
+// 缩放、尺寸变化或瓦片内容变化（refresh）时对应区域失效重画。
+class MAPGRAPHICSVIEW_EXPORT MapTileLayerItem : public QGraphicsItem
+{
+public:
+    explicit MapTileLayerItem(MapTileManager* manager);
+
+    // 世界范围（scene 级别下整张地图的像素大小）
+    void setWorldSize(qreal size);
+
+    // 瓦片内容变化：后备缓冲中对应区域失效并重绘（sceneRect 为空表示全部）
+    void refresh(const QRectF& sceneRect = QRectF());
+
+    // 调试用：绘制瓦片边框
+    void setShowTileBorders(bool show);
+    bool showTileBorders() const { return m_showBorders; }
+
+    QRectF boundingRect() const override;
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget) override;
+
+private:
+    void drawTiles(QPainter* painter, const QRectF& exposed) const;
+    void updateBackbuffer(const QTransform& t, QWidget* widget);
+    bool drawFallback(QPainter* painter, int z, int x, int y, const QRectF& target) const;
+
+private:
+    MapTileManager* m_manager = nullptr;
+    qreal m_worldSize = 0.0;
+    bool m_showBorders = false;
+
+    // 后备缓冲（viewport 设备坐标）
+    QPixmap m_buffer;
+    QPointF m_bufferOrigin;    // 缓冲左上角（物理像素 0,0）对应的 scene 坐标
+    qreal   m_bufferScale = 0.0;
+    QRegion m_bufferDirty;     // 待重画区域（缓冲物理像素）
+};
@@ -0,0 +1,484 @@
+#include "maptilemanager.h"
+
+#include "bingformula.h"
+#include "maptilelayeritem.h"
+#include <QGraphicsScene>
+#include <QFile>
+#include <QThread>
+#include <QtMath>
+#include <cmath>
+
+namespace {
+constexpr int TILE_SIZE = 256;
+
+// 预取请求的优先级偏置：总排在视口内瓦片之后，相邻级别再按级差往后排
+constexpr double PREFETCH_BIAS      = 1.0e6;
+constexpr double LEVEL_BIAS         = 1.0e3;
+constexpr double PREFETCH_REACH     = 2.0;   // 预取请求离视口中心超过几个视口对角线即取消
+
+constexpr int MAX_PREFETCH_PENDING = 64;     // 在途请求超过此数时不再预取，避免挤占视口瓦片
+constexpr int MAX_PREFETCH_TRACKED = 1024;   // 跟踪中的预取瓦片上限
+}
+
+MapTileManager::MapTileManager(QGraphicsScene* scene, QObject* parent)
+    : QObject(parent)
+    , m_scene(scene)
+    , m_scheduler(&m_pool, [this](const MapTileRequest& request) { decodeTile(request); })
+{
+    // 给主线程留一个核
+    m_pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+
+    // 整个底图只有这一个场景图元
+    m_layer = new MapTileLayerItem(this);
+    m_scene->addItem(m_layer);
+}
+
+MapTileManager::~MapTileManager()
+{
+    // 先让解码线程退出，避免回调访问已析构对象
+    m_scheduler.cancelAll();
+    m_pool.waitForDone();
+}
+
+/**
+ * @brief             设置瓦片来源，清空已加载的瓦片和已登记的级别
+ * @param mapRootPath 离线地图根目录
+ * @param sceneZoom   scene 坐标所用级别
+ */
+void MapTileManager::setSource(const QString& mapRootPath, int sceneZoom)
+{
+    clear();
+    m_pool.waitForDone();   // 正在解码的任务可能还引用着瓦片包的映射区
+    m_archive.close();
+
+    m_mapRoot   = mapRootPath;
+    m_sceneZoom = sceneZoom;
+    m_zoom      = sceneZoom;
+
+    m_cache.clear();   // 来源变化，旧缓存失效
+    m_catalog.clear();
+
+    m_layer->setWorldSize(Bing::mapSize(sceneZoom));
+}
+
+/**
+ * @brief             打开单文件瓦片包，之后瓦片从映射区读取
+ * @param archivePath 瓦片包路径
+ * @return            成功返回 true
+ */
+bool MapTileManager::openArchive(const QString& archivePath)
+{
+    m_pool.waitForDone();
+    return m_archive.open(archivePath);
+}
+
+/**
+ * @brief      切换显示级别
+ * @param zoom 新级别
+ */
+void MapTileManager::setLevel(int zoom)
+{
+    if (zoom == m_zoom)
+        return;
+
+    m_zoom = zoom;
+    m_wantRange = QRect();   // 强制下次 updateViewport 重新计算
+
+    // 旧级别瓦片仍在热层缓存里，新级别到齐前由图层拿来临时填充
+    m_resident.clear();
+    m_layer->refresh();
+}
+
+void MapTileManager::setMargin(int tiles)
+{
+    m_margin = qMax(0, tiles);
+}
+
+/**
+ * @brief 移除所有瓦片并作废未完成的请求
+ */
+void MapTileManager::clear()
+{
+    ++m_generation;
+    m_scheduler.cancelAll();   // 尚未开始的请求直接丢弃
+    {
+        QMutexLocker locker(&m_resultMutex);
+        m_results.clear();
+    }
+
+    m_resident.clear();
+    m_pending.clear();
+    m_prefetched.clear();
+    m_prefetcher.reset();
+    m_wantRange = QRect();
+    m_viewRect  = QRectF();
+    m_layer->refresh();
+}
+
+bool MapTileManager::residentTile(const TileKey& key, QPixmap& pix) const
+{
+    auto it = m_resident.constFind(key.code());
+    if (it == m_resident.constEnd())
+        return false;
+
+    pix = it.value();
+    return true;
+}
+
+QRectF MapTileManager::tileSceneRect(const TileKey& key) const
+{
+    const double span = tileSpan(key.z);
+    return QRectF(key.x * span, key.y * span, span, span);
+}
+
+/**
+ * @brief           scene 范围转瓦片编号范围（含外扩边距）
+ * @param sceneRect scene 坐标（当前级别像素）
+ * @return          瓦片编号范围（闭区间）
+ */
+QRect MapTileManager::tileRangeOf(const QRectF& sceneRect) const
+{
+    return tileRangeOf(sceneRect, m_zoom, m_margin);
+}
+
+QRect MapTileManager::tileRangeOf(const QRectF& sceneRect, int zoom, int margin) const
+{
+    const double span = tileSpan(zoom);
+    const int x0 = qFloor(sceneRect.left()   / span) - margin;
+    const int y0 = qFloor(sceneRect.top()    / span) - margin;
+    const int x1 = qFloor(sceneRect.right()  / span) + margin;
+    const int y1 = qFloor(sceneRect.bottom() / span) + margin;
+    return QRect(QPoint(x0, y0), QPoint(x1, y1));
+}
+
+/**
+ * @brief      某级别一块瓦片在 scene 中的边长（scene 级别下为 256）
+ * @param zoom 瓦片级别
+ */
+double MapTileManager::tileSpan(int zoom) const
+{
+    return std::ldexp(double(TILE_SIZE), m_sceneZoom - zoom);
+}
+
+QString MapTileManager::tilePath(const TileKey& key) const
+{
+    return m_mapRoot + QString("/%1/%2/%3.%4").arg(key.z).arg(key.x).arg(key.y).arg(m_format);
+}
+
+/**
+ * @brief           视口变化：请求新进入范围的瓦片，移除离开范围的瓦片
+ * @param sceneRect 当前视口对应的 scene 范围
+ */
+void MapTileManager::updateViewport(const QRectF& sceneRect)
+{
+    if (sceneRect.isEmpty() || m_catalog.isEmpty())
+        return;
+
+    m_viewRect = sceneRect;
+    m_prefetcher.observeViewport(sceneRect);
+
+    const QRect range = tileRangeOf(sceneRect);
+    if (range == m_wantRange)
+    {
+        // 瓦片范围没变，但平移仍在继续，预测位置可能已进入新的瓦片
+        const QRectF ahead = m_prefetcher.predictedRect();
+        if (!ahead.isEmpty())
+            prefetchRange(m_zoom, tileRangeOf(ahead));
+        return;
+    }
+    m_wantRange = range;
+
+    // 0) 按新视口重排队列，取消已离开范围的请求（跳转后只剩可见瓦片排队）
+    rescheduleRequests();
+
+    // 1) 释放离开范围的瓦片（像素仍在热层缓存中，按 LRU 淘汰）
+    for (auto it = m_resident.begin(); it != m_resident.end();)
+    {
+        if (!range.contains(MapTileKey::tileX(it.key()), MapTileKey::tileY(it.key())))
+            it = m_resident.erase(it);
+        else
+            ++it;
+    }
+
+    // 2) 请求范围内缺失的瓦片
+    int ready = 0;
+    QRectF dirty;
+    for (int x = range.left(); x <= range.right(); ++x)
+    {
+        for (int y = range.top(); y <= range.bottom(); ++y)
+        {
+            const TileKey key(m_zoom, x, y);
+            const quint64 code = key.code();
+            if (m_resident.contains(code) || m_pending.contains(code) || !m_catalog.contains(key.z, key.x, key.y))
+                continue;
+            if (requestTile(key))
+            {
+                dirty |= tileSceneRect(key);
+                ++ready;
+            }
+        }
+    }
+
+    if (ready > 0)
+    {
+        m_layer->refresh(dirty);
+        emit tilesLoaded(ready);
+    }
+
+    // 3) 视口内请求全部发出后，再按平移方向预取
+    const QRectF ahead = m_prefetcher.predictedRect();
+    if (!ahead.isEmpty())
+        prefetchRange(m_zoom, tileRangeOf(ahead));
+}
+
+/**
+ * @brief                滚轮缩放：预取光标附近相邻级别的瓦片，切换级别时可直接从热层取用
+ * @param zoomIn         true：放大
+ * @param cursorScenePos 光标处的 scene 坐标
+ */
+void MapTileManager::noteZoom(bool zoomIn, const QPointF& cursorScenePos)
+{
+    if (m_viewRect.isEmpty() || m_catalog.isEmpty())
+        return;
+
+    // 相邻的已有级别
+    const QList<int> levels = m_catalog.levels();
+    const int index = levels.indexOf(m_zoom);
+    const int next  = index < 0 ? -1 : index + (zoomIn ? 1 : -1);
+    if (next < 0 || next >= levels.size())
+        return;
+
+    // 以光标为中心：放大后视口约为一半，缩小后约为两倍
+    const double factor = zoomIn ? 0.5 : 2.0;
+    QRectF rect(QPointF(), m_viewRect.size() * factor);
+    rect.moveCenter(cursorScenePos);
+    prefetchRange(levels[next], tileRangeOf(rect, levels[next], 0));
+}
+
+/**
+ * @brief       低优先级预取一个范围内的瓦片（已驻留、在途、热层已有的跳过）
+ * @param zoom  级别
+ * @param range 瓦片编号范围（闭区间）
+ * @return      新发出的预取数
+ */
+int MapTileManager::prefetchRange(int zoom, const QRect& range)
+{
+    if (m_prefetched.size() > MAX_PREFETCH_TRACKED)
+        m_prefetched.clear();   // 长期未用到的预取不再跟踪，按未命中处理
+
+    int issued = 0;
+    for (int x = range.left(); x <= range.right(); ++x)
+    {
+        for (int y = range.top(); y <= range.bottom(); ++y)
+        {
+            if (m_pending.size() >= MAX_PREFETCH_PENDING)
+                return issued;
+
+            const TileKey key(zoom, x, y);
+            const quint64 code = key.code();
+            if (m_resident.contains(code) || m_pending.contains(code) || m_cache.containsDecoded(key) ||
+                !m_catalog.contains(key.z, key.x, key.y))
+                continue;
+
+            m_prefetched.insert(code);   // 先登记，调度优先级据此区分预取
+            requestTile(key, true);
+            ++m_prefetchStats.issued;
+            ++issued;
+        }
+    }
+    return issued;
+}
+
+void MapTileManager::notePrefetchUsed(const TileKey& key)
+{
+    if (m_prefetched.remove(key.code()))
+        ++m_prefetchStats.hits;
+}
+
+/**
+ * @brief          请求瓦片：热层命中直接可用，冷层命中只解码，都未命中再读盘
+ * @param key      瓦片键
+ * @param prefetch 预取请求：只提交低优先级解码，结果只进缓存
+ * @return         热层命中（已可绘制）返回 true，否则已提交异步解码
+ */
+bool MapTileManager::requestTile(const TileKey& key, bool prefetch)
+{
+    const quint64 code = key.code();
+    QPixmap pix;
+    if (!prefetch && m_cache.findDecoded(key, pix))
+    {
+        m_resident.insert(code, pix);
+        notePrefetchUsed(key);
+        return true;
+    }
+
+    // 瓦片包的数据本来就在映射区里，不需要冷层
+    const bool useArchive = m_archive.isOpen();
+
+    // 只统计视口请求：预取不是缓存访问（只读查找，不计命中、不刷新 LRU），瓦片包没有冷层
+    QByteArray bytes;
+    if (!useArchive)
+    {
+        if (prefetch)
+            m_cache.peekCompressed(key, bytes);
+        else if (!m_cache.findCompressed(key, bytes))
+            m_cache.recordMiss();
+    }
+
+    m_pending.insert(code);
+
+    MapTileRequest request;
+    request.key        = key;
+    request.priority   = priorityOf(key);
+    request.generation = m_generation;
+    request.bytes      = bytes;
+    m_scheduler.enqueue(request);
+    return false;
+}
+
+/**
+ * @brief     调度优先级：视口内瓦片按到视口中心的距离（瓦片数）排序，
+ *            预取瓦片排在其后；既不在视口内也不在预取范围内的返回 -1
+ * @param key 瓦片键
+ */
+double MapTileManager::priorityOf(const TileKey& key) const
+{
+    const double span = tileSpan(m_zoom);
+    const QPointF offset = (tileSceneRect(key).center() - m_viewRect.center()) / span;
+    const double distance = std::hypot(offset.x(), offset.y());
+
+    if (key.z == m_zoom && m_wantRange.contains(key.x, key.y))
+        return distance;
+    if (!m_prefetched.contains(key.code()))
+        return -1.0;
+
+    const double reach = PREFETCH_REACH * std::hypot(m_viewRect.width(), m_viewRect.height()) / span + 1.0;
+    if (distance > reach)
+        return -1.0;
+    return PREFETCH_BIAS + LEVEL_BIAS * std::abs(key.z - m_zoom) + distance;
+}
+
+/**
+ * @brief 视口变化后重排解码队列，取消不再需要的请求
+ */
+void MapTileManager::rescheduleRequests()
+{
+    const QVector<TileKey> cancelled = m_scheduler.reprioritize(
+        [this](const TileKey& key) { return priorityOf(key); });
+
+    for (const TileKey& key : cancelled)
+    {
+        const quint64 code = key.code();
+        m_pending.remove(code);
+        m_prefetched.remove(code);
+    }
+}
+
+/**
+ * @brief         工作线程：读取（瓦片包 / 冷层数据 / 文件）并解码，结果交给主线程
+ * @param request 解码请求
+ */
+void MapTileManager::decodeTile(const MapTileRequest& request)
+{
+    DecodedTile tile;
+    tile.generation = request.generation;
+    tile.key        = request.key;
+    tile.bytes      = request.bytes;
+    if (m_archive.isOpen())
+    {
+        tile.bytes = m_archive.tileData(request.key);   // 直接引用映射区，无需 open()
+    }
+    else if (tile.bytes.isEmpty())
+    {
+        QFile file(tilePath(request.key));
+        if (file.open(QIODevice::ReadOnly))
+            tile.bytes = file.readAll();
+    }
+    tile.img = decodeForBlit(tile.bytes);
+
+    postResult(std::move(tile));
+}
+
+/**
+ * @brief       在工作线程中解码，并转换为绘制最快的格式（不透明 RGB32 / 透明预乘 ARGB32）
+ * @param bytes 压缩后的瓦片数据
+ * @return      解码后的图像（失败为空）
+ */
+QImage MapTileManager::decodeForBlit(const QByteArray& bytes)
+{
+    QImage img;
+    if (bytes.isEmpty() || !img.loadFromData(bytes))
+        return QImage();
+
+    const QImage::Format fmt = img.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied
+                                                     : QImage::Format_RGB32;
+    if (img.format() != fmt)
+        img = std::move(img).convertToFormat(fmt);
+    return img;
+}
+
+/**
+ * @brief      工作线程提交解码结果：只有批次为空时才唤醒主线程一次，
+ *             主线程在同一轮事件循环里一次性取走整批结果
+ * @param tile 解码结果
+ */
+void MapTileManager::postResult(DecodedTile&& tile)
+{
+    bool wake = false;
+    {
+        QMutexLocker locker(&m_resultMutex);
+        wake = m_results.isEmpty();
+        m_results.append(std::move(tile));
+    }
+
+    // 析构时会等待线程池，this 在此期间有效
+    if (wake)
+        QMetaObject::invokeMethod(this, &MapTileManager::drainResults, Qt::QueuedConnection);
+}
+
+/**
+ * @brief 主线程取走整批解码结果，入缓存并上图
+ */
+void MapTileManager::drainResults()
+{
+    QVector<DecodedTile> batch;
+    {
+        QMutexLocker locker(&m_resultMutex);
+        batch.swap(m_results);
+    }
+
+    int added = 0;
+    QRectF dirty;
+    for (DecodedTile& tile : batch)
+    {
+        if (tile.generation != m_generation)
+            continue;   // 来源已切换，结果作废
+
+        const quint64 code = tile.key.code();
+        m_pending.remove(code);
+        if (tile.img.isNull())
+            continue;
+
+        // 先入缓存：即使解码期间已移出视口，下次回来也不必再读盘/解码
+        const QPixmap pix = QPixmap::fromImage(std::move(tile.img), Qt::NoFormatConversion);
+        if (!m_archive.isOpen())
+            m_cache.insertCompressed(tile.key, tile.bytes);
+        m_cache.insertDecoded(tile.key, pix);
+
+        if (tile.key.z != m_zoom || !m_wantRange.contains(tile.key.x, tile.key.y))
+            continue;
+
+        // 与热层缓存共享同一份像素数据
+        m_resident.insert(code, pix);
+        notePrefetchUsed(tile.key);
+        dirty |= tileSceneRect(tile.key);
+        ++added;
+    }
+
+    // 只重绘新到瓦片覆盖的区域
+    if (added > 0)
+    {
+        m_layer->refresh(dirty);
+        emit tilesLoaded(added);
+    }
+}
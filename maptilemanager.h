@@ -0,0 +1,136 @@
+#pragma once
+#include "mapgraphicsview_global.h"
+#include "mapStruct.h"
+#include "maptilecache.h"
+#include "maptilearchive.h"
+#include "maptilecatalog.h"
+#include "maptileprefetcher.h"
+#include "maptilescheduler.h"
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QRect>
+#include <QRectF>
+#include <QImage>
+#include <QMutex>
+#include <QThreadPool>
+#include <QVector>
+
+class QGraphicsScene;
+class MapTileLayerItem;
+
+// 视口驱动的瓦片管理器：只加载视口（含外扩边距）内的瓦片，
+// 离开范围的瓦片不再驻留，启动时间和内存只与屏幕大小相关。
+// 底图由唯一的 MapTileLayerItem 绘制，场景图元数量与地图范围无关。
+class MAPGRAPHICSVIEW_EXPORT MapTileManager : public QObject
+{
+    Q_OBJECT
+public:
+    explicit MapTileManager(QGraphicsScene* scene, QObject* parent = nullptr);
+    ~MapTileManager() override;
+
+    // 设置瓦片来源：根目录、scene 坐标所用级别（scene 像素 = 该级别像素）
+    void setSource(const QString& mapRootPath, int sceneZoom);
+    // 使用单文件瓦片包代替目录结构（在 setSource 之后调用），返回是否打开成功
+    bool openArchive(const QString& archivePath);
+    const MapTileArchive& archive() const { return m_archive; }
+
+    // 磁盘/瓦片包中存在哪些瓦片（在 setSource 之后填充）
+    MapTileCatalog& catalog() { return m_catalog; }
+    const MapTileCatalog& catalog() const { return m_catalog; }
+    QList<int> levels() const { return m_catalog.levels(); }
+
+    // 切换显示级别：新级别瓦片加载完之前，旧级别瓦片保留在下层作为过渡
+    void setLevel(int zoom);
+    int level() const { return m_zoom; }
+    int sceneZoom() const { return m_sceneZoom; }
+
+    // 视口外额外加载的瓦片圈数（默认 1）
+    void setMargin(int tiles);
+    int margin() const { return m_margin; }
+
+    // 视口（scene 坐标）变化时调用：请求新进入的瓦片，移除离开的瓦片，
+    // 并按平移速度低优先级预取视口即将到达的瓦片
+    void updateViewport(const QRectF& sceneRect);
+    // 滚轮缩放时调用：低优先级预取光标附近下一个（放大）/上一个（缩小）级别的瓦片
+    void noteZoom(bool zoomIn, const QPointF& cursorScenePos);
+
+    // 预取前瞻时间（毫秒，0 关闭平移预取）
+    void setPrefetchLookahead(int ms) { m_prefetcher.setLookaheadMs(ms); }
+    int prefetchLookahead() const { return m_prefetcher.lookaheadMs(); }
+    MapPrefetchStats prefetchStats() const { return m_prefetchStats; }
+    void resetPrefetchStats() { m_prefetchStats = MapPrefetchStats(); }
+
+    // 移除所有瓦片并丢弃未完成的请求
+    void clear();
+
+    // 两级瓦片缓存（预算、命中/淘汰统计）
+    MapTileCache& cache() { return m_cache; }
+    const MapTileCache& cache() const { return m_cache; }
+
+    // 底图图层（由管理器创建并加入场景）
+    MapTileLayerItem* layerItem() const { return m_layer; }
+
+    // 当前级别、视口范围内已就绪的瓦片（图层绘制用）
+    bool residentTile(const TileKey& key, QPixmap& pix) const;
+    double tileSpan(int zoom) const;                  // 某级别一块瓦片在 scene 中的边长
+    QRectF tileSceneRect(const TileKey& key) const;   // 瓦片在 scene 中的范围
+
+    int loadedCount() const { return m_resident.size(); }
+    int pendingCount() const { return m_pending.size(); }
+
+signals:
+    void tilesLoaded(int count);   // 每批就绪一次（不是每块瓦片一次）
+
+private:
+    QRect tileRangeOf(const QRectF& sceneRect) const;   // scene 范围 → 当前级别瓦片编号范围（含边距）
+    QRect tileRangeOf(const QRectF& sceneRect, int zoom, int margin) const;
+    QString tilePath(const TileKey& key) const;
+    bool requestTile(const TileKey& key, bool prefetch = false);
+    double priorityOf(const TileKey& key) const;        // 调度优先级，负数表示不再需要
+    void rescheduleRequests();                          // 视口变化后重排并取消过期请求
+    int prefetchRange(int zoom, const QRect& range);   // 返回新发出的预取数
+    void notePrefetchUsed(const TileKey& key);
+
+    // 工作线程解码结果
+    struct DecodedTile
+    {
+        quint64 generation = 0;
+        TileKey key;
+        QByteArray bytes;
+        QImage img;
+    };
+    static QImage decodeForBlit(const QByteArray& bytes);
+    void decodeTile(const MapTileRequest& request);   // 工作线程调用
+    void postResult(DecodedTile&& tile);              // 工作线程调用
+    void drainResults();                   // 主线程批量处理
+
+private:
+    QGraphicsScene* m_scene = nullptr;
+    MapTileLayerItem* m_layer = nullptr;
+    QThreadPool m_pool;
+    MapTileScheduler m_scheduler;                     // 按视口距离排序、可取消的解码队列
+
+    QString m_mapRoot;
+    QString m_format = "jpg";
+    int m_sceneZoom = 17;   // scene 坐标所用级别
+    int m_zoom = 17;        // 当前显示级别
+    int m_margin = 1;
+
+    MapTileCatalog m_catalog;                         // 磁盘上存在的瓦片（所有级别）
+    QHash<quint64, QPixmap> m_resident;               // 当前级别、视口范围内已就绪的瓦片
+    QSet<quint64> m_pending;                          // 排队或解码中的瓦片
+    MapTileCache m_cache;                             // 离开视口的瓦片仍保留在缓存中
+    MapTileArchive m_archive;                         // 打开时优先从瓦片包读取（工作线程只读访问）
+    QRect m_wantRange;                                // 当前级别需要的瓦片编号范围
+    QRectF m_viewRect;                                // 最近一次的视口（scene 坐标）
+
+    MapTilePrefetcher m_prefetcher;
+    QSet<quint64> m_prefetched;                       // 预取过、尚未被视口使用的瓦片
+    MapPrefetchStats m_prefetchStats;
+
+    QMutex m_resultMutex;
+    QVector<DecodedTile> m_results;                   // 待主线程处理的解码结果（受 m_resultMutex 保护）
+
+    quint64 m_generation = 0;                         // setSource/clear 后递增，用于丢弃过期结果
+};
@@ -0,0 +1,68 @@
+#include "maptileprefetcher.h"
+
+#include <QtMath>
+
+namespace {
+constexpr qint64 IDLE_MS   = 150;   // 超过这么久没动视为静止
+constexpr double SMOOTHING = 0.5;   // 速度指数平滑系数
+}
+
+MapTilePrefetcher::MapTilePrefetcher()
+{
+    m_clock.start();
+}
+
+void MapTilePrefetcher::reset()
+{
+    m_lastRect = QRectF();
+    m_lastMs   = -1;
+    m_velocity = QPointF();
+}
+
+/**
+ * @brief           由视口中心的位移估计平移速度
+ * @param sceneRect 当前视口（scene 坐标）
+ */
+void MapTilePrefetcher::observeViewport(const QRectF& sceneRect)
+{
+    const qint64 now = m_clock.elapsed();
+
+    // 视口尺寸变化（缩放）不算平移
+    if (m_lastMs >= 0 && m_lastRect.size() == sceneRect.size())
+    {
+        const qint64 dt = now - m_lastMs;
+        if (dt > IDLE_MS)
+        {
+            m_velocity = QPointF();
+        }
+        else if (dt > 0)
+        {
+            const QPointF v = (sceneRect.center() - m_lastRect.center()) * (1000.0 / dt);
+            m_velocity = m_velocity * (1.0 - SMOOTHING) + v * SMOOTHING;
+        }
+    }
+    else
+    {
+        m_velocity = QPointF();
+    }
+
+    m_lastRect = sceneRect;
+    m_lastMs   = now;
+}
+
+/**
+ * @brief  视口沿当前速度方向前移 lookahead 后的位置，位移最多一个视口大小
+ */
+QRectF MapTilePrefetcher::predictedRect() const
+{
+    if (m_lastMs < 0 || m_clock.elapsed() - m_lastMs > IDLE_MS || m_velocity.isNull())
+        return QRectF();
+
+    QPointF shift = m_velocity * (m_lookaheadMs / 1000.0);
+    shift.setX(qBound(-m_lastRect.width(),  shift.x(), m_lastRect.width()));
+    shift.setY(qBound(-m_lastRect.height(), shift.y(), m_lastRect.height()));
+
+    if (qAbs(shift.x()) < 1.0 && qAbs(shift.y()) < 1.0)
+        return QRectF();
+    return m_lastRect.translated(shift);
+}
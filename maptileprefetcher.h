@@ -0,0 +1,42 @@
+#pragma once
+#include "mapgraphicsview_global.h"
+#include <QElapsedTimer>
+#include <QPointF>
+#include <QRectF>
+
+// 预取命中统计
+struct MapPrefetchStats
+{
+    quint64 issued = 0;   // 发出的预取请求数
+    quint64 hits   = 0;   // 预取的瓦片随后进入视口被使用的次数
+
+    double hitRate() const { return issued ? double(hits) / double(issued) : 0.0; }
+};
+
+// 平移速度跟踪：根据连续的视口位置估计移动速度（scene 像素/秒），
+// 预测视口即将到达的区域。
+class MAPGRAPHICSVIEW_EXPORT MapTilePrefetcher
+{
+public:
+    MapTilePrefetcher();
+
+    // 每次视口变化时调用
+    void observeViewport(const QRectF& sceneRect);
+
+    // 预测视口在 lookahead 之后覆盖的区域（静止时为空）
+    QRectF predictedRect() const;
+    QPointF velocity() const { return m_velocity; }
+
+    void setLookaheadMs(int ms) { m_lookaheadMs = qMax(0, ms); }
+    int lookaheadMs() const { return m_lookaheadMs; }
+
+    void reset();
+
+private:
+    QElapsedTimer m_clock;
+    QRectF m_lastRect;
+    qint64 m_lastMs = -1;
+    QPointF m_velocity;          // 指数平滑后的速度（scene 像素/秒）
+
+    int m_lookaheadMs = 400;
+};
@@ -0,0 +1,127 @@
+#include "maptilescheduler.h"
+
+#include <QThreadPool>
+#include <iterator>
+
+MapTileScheduler::MapTileScheduler(QThreadPool* pool, Handler handler)
+    : m_pool(pool)
+    , m_handler(std::move(handler))
+{
+}
+
+MapTileScheduler::~MapTileScheduler()
+{
+    // 工作循环引用着 this，必须等它们全部退出
+    cancelAll();
+    m_pool->waitForDone();
+}
+
+/**
+ * @brief         提交请求；同一瓦片已在队列中时合并为一个
+ * @param request 解码请求
+ * @return        新加入队列返回 true
+ */
+bool MapTileScheduler::enqueue(const MapTileRequest& request)
+{
+    QMutexLocker locker(&m_mutex);
+
+    const quint64 code = request.key.code();
+    auto it = m_queue.find(code);
+    if (it != m_queue.end())
+    {
+        it->priority = qMin(it->priority, request.priority);
+        return false;
+    }
+
+    m_queue.insert(code, request);
+    startWorkers();
+    return true;
+}
+
+bool MapTileScheduler::isQueued(const TileKey& key) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_queue.contains(key.code());
+}
+
+int MapTileScheduler::queuedCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_queue.size();
+}
+
+/**
+ * @brief            视口变化后重排队列
+ * @param priorityOf 新优先级（负数表示取消）
+ * @return           被取消的瓦片
+ */
+QVector<TileKey> MapTileScheduler::reprioritize(const std::function<double(const TileKey&)>& priorityOf)
+{
+    QVector<TileKey> cancelled;
+
+    QMutexLocker locker(&m_mutex);
+    for (auto it = m_queue.begin(); it != m_queue.end();)
+    {
+        const double priority = priorityOf(it->key);
+        if (priority < 0.0)
+        {
+            cancelled.append(it->key);
+            it = m_queue.erase(it);
+        }
+        else
+        {
+            it->priority = priority;
+            ++it;
+        }
+    }
+    return cancelled;
+}
+
+void MapTileScheduler::cancelAll()
+{
+    QMutexLocker locker(&m_mutex);
+    m_queue.clear();
+}
+
+/**
+ * @brief 队列中的请求多于工作循环时补足工作循环（不超过线程池上限）
+ */
+void MapTileScheduler::startWorkers()
+{
+    while (m_workers < m_pool->maxThreadCount() && m_workers < m_queue.size())
+    {
+        ++m_workers;
+        m_pool->start([this]() { workerLoop(); });
+    }
+}
+
+/**
+ * @brief 工作线程：反复取出优先级最高的请求处理，队列空时退出
+ */
+void MapTileScheduler::workerLoop()
+{
+    for (;;)
+    {
+        MapTileRequest request;
+        {
+            QMutexLocker locker(&m_mutex);
+            if (m_queue.isEmpty())
+            {
+                --m_workers;
+                return;
+            }
+
+            // 队列长度与视口瓦片数同量级，线性查找即可，且重排时无需维护堆
+            auto best = m_queue.begin();
+            for (auto it = std::next(best); it != m_queue.end(); ++it)
+            {
+                if (it->priority < best->priority)
+                    best = it;
+            }
+            request = std::move(best.value());
+            m_queue.erase(best);
+        }
+
+        m_handler(request);
+    }
+}
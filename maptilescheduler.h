@@ -0,0 +1,54 @@
+#pragma once
+#include "mapgraphicsview_global.h"
+#include "mapStruct.h"
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QVector>
+#include <functional>
+
+class QThreadPool;
+
+// 一次瓦片解码请求
+struct MapTileRequest
+{
+    TileKey key;
+    double priority = 0.0;     // 越小越先处理
+    quint64 generation = 0;    // 提交时的来源代数
+    QByteArray bytes;          // 冷层命中时的压缩数据（为空则由处理函数读取）
+};
+
+// 瓦片请求调度器：
+//   请求先进入按优先级排序的队列，线程池中的工作线程每次取优先级最高的一个处理；
+//   同一瓦片重复提交只合并（保留较高优先级），视口移动后可整体重排并取消不再需要的请求。
+//   与 QThreadPool 直接排队不同，尚未开始的请求始终可以重排和取消。
+class MAPGRAPHICSVIEW_EXPORT MapTileScheduler
+{
+public:
+    using Handler = std::function<void(const MapTileRequest&)>;   // 在工作线程中调用
+
+    MapTileScheduler(QThreadPool* pool, Handler handler);
+    ~MapTileScheduler();
+
+    // 加入队列；已在队列中时只提升优先级，返回是否为新请求
+    bool enqueue(const MapTileRequest& request);
+    bool isQueued(const TileKey& key) const;
+    int queuedCount() const;
+
+    // 按 priorityOf 重新计算所有排队请求的优先级，返回负数的请求被取消；返回被取消的瓦片
+    QVector<TileKey> reprioritize(const std::function<double(const TileKey&)>& priorityOf);
+    // 取消所有尚未开始的请求（已开始的照常完成）
+    void cancelAll();
+
+private:
+    void workerLoop();
+    void startWorkers();   // 调用方持有 m_mutex
+
+private:
+    QThreadPool* m_pool = nullptr;
+    Handler m_handler;
+
+    mutable QMutex m_mutex;
+    QHash<quint64, MapTileRequest> m_queue;   // 键为 TileKey::code()，受 m_mutex 保护
+    int m_workers = 0;                        // 正在运行的工作循环数（受 m_mutex 保护）
+};
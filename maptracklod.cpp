@@ -0,0 +1,109 @@
+#include "maptracklod.h"
+
+#include "maptrackpool.h"
+#include <QtMath>
+#include <cmath>
+
+/**
+ * @brief           按缩放比选择网格档位（一格不超过一个屏幕像素）
+ * @param viewScale view 像素 / scene 像素
+ */
+void MapTrackLod::setScale(double viewScale)
+{
+    const int shift = viewScale >= 1.0 || viewScale <= 0.0
+        ? 0 : int(std::floor(std::log2(1.0 / viewScale)));
+    if (shift == m_shift)
+        return;
+
+    m_shift = shift;
+    m_cell  = std::ldexp(1.0, shift);
+    m_caches.clear();
+}
+
+void MapTrackLod::append(Cache& c, const QPointF& pt, quint64 seq)
+{
+    const qint64 cx = qint64(std::floor(pt.x() / m_cell));
+    const qint64 cy = qint64(std::floor(pt.y() / m_cell));
+
+    // 与上一个保留点同格：用新点替换，折线末端始终是最新位置
+    if (c.pts.size() > c.begin + 1 && cx == c.lastCellX && cy == c.lastCellY)
+    {
+        c.pts.last() = pt;
+        c.seq.last() = seq;
+        return;
+    }
+
+    c.pts.append(pt);
+    c.seq.append(seq);
+    c.lastCellX = cx;
+    c.lastCellY = cy;
+}
+
+void MapTrackLod::rebuild(Cache& c, const MapTrackPool& pool, int slot)
+{
+    c = Cache();
+
+    const int n = pool.size(slot);
+    const quint64 first = pool.appended(slot) - quint64(n);
+    for (int i = 0; i < n; ++i)
+        append(c, pool.at(slot, i), first + quint64(i));
+    c.synced = pool.appended(slot);
+}
+
+/**
+ * @brief        增量更新并返回简化后的航迹
+ * @param pool   航迹池
+ * @param slot   航迹号
+ * @param points 输出：简化后的点（在下次调用前有效）
+ * @return       点数
+ */
+int MapTrackLod::simplified(const MapTrackPool& pool, int slot, const QPointF*& points)
+{
+    if (slot >= m_caches.size())
+        m_caches.resize(slot + 1);
+    Cache& c = m_caches[slot];
+
+    const int n = pool.size(slot);
+    const quint64 appended = pool.appended(slot);
+    const quint64 fresh = appended - c.synced;
+
+    if (appended < c.synced || fresh > quint64(n))
+    {
+        // 积压的新点比环中的还多（或航迹被重建），直接重算
+        rebuild(c, pool, slot);
+    }
+    else
+    {
+        // 只处理新追加的点
+        for (int i = n - int(fresh); i < n; ++i)
+            append(c, pool.at(slot, i), appended - quint64(n - i));
+        c.synced = appended;
+
+        // 丢弃已被覆盖的点，并把源航迹当前最旧点补到头部（前移后头部必有空位）
+        const quint64 oldest = appended - quint64(n);
+        int drop = c.begin;
+        while (drop < c.seq.size() && c.seq[drop] < oldest)
+            ++drop;
+        if (drop > c.begin && n > 0)
+        {
+            if (drop == c.seq.size() || c.seq[drop] != oldest)
+            {
+                --drop;
+                c.pts[drop] = pool.first(slot);
+                c.seq[drop] = oldest;
+            }
+            c.begin = drop;
+        }
+
+        // 头部空洞过半时压缩
+        if (c.begin > 64 && c.begin * 2 > c.pts.size())
+        {
+            c.pts.erase(c.pts.begin(), c.pts.begin() + c.begin);
+            c.seq.erase(c.seq.begin(), c.seq.begin() + c.begin);
+            c.begin = 0;
+        }
+    }
+
+    points = c.pts.constData() + c.begin;
+    return c.pts.size() - c.begin;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include "mapgraphicsview_global.h"
+#include <QPointF>
+#include <QVector>
+
+class MapTrackPool;
+
+// 航迹按缩放简化（像素格抽稀）：
+//   scene 平面按 2^k 像素划分网格（k 由缩放比决定，一格不超过一个屏幕像素），
+//   相邻点落在同一格时只保留最新的一个。简化结果按航迹缓存，追加点时只处理新点，
+//   最旧点被覆盖时从头部丢弃，绘制开销与屏幕分辨率相关而与航迹长度无关。
+class MAPGRAPHICSVIEW_EXPORT MapTrackLod
+{
+public:
+    // 视图缩放比（view 像素 / scene 像素）；网格档位变化时清空缓存
+    void setScale(double viewScale);
+    double cellSize() const { return m_cell; }
+
+    // 取简化后的航迹（最旧 → 最新），返回点数，points 指向内部缓存
+    int simplified(const MapTrackPool& pool, int slot, const QPointF*& points);
+
+    void clear() { m_caches.clear(); }
+
+private:
+    struct Cache
+    {
+        QVector<QPointF> pts;
+        QVector<quint64> seq;    // 每个保留点在源航迹中的序号
+        int begin = 0;           // 有效数据起点（头部丢弃时只前移，不搬移）
+        quint64 synced = 0;      // 已处理到的源航迹累计点数
+        qint64 lastCellX = 0;
+        qint64 lastCellY = 0;
+    };
+
+    void append(Cache& c, const QPointF& pt, quint64 seq);
+    void rebuild(Cache& c, const MapTrackPool& pool, int slot);
+
+private:
+    int m_shift = 0;        // 网格边长 = 2^m_shift scene 像素
+    double m_cell = 1.0;
+    QVector<Cache> m_caches;
+};
@@ -0,0 +1,134 @@
+#include "maptrackpool.h"
+
+#include <algorithm>
+
+MapTrackPool::MapTrackPool(int capacity)
+    : m_capacity(qMax(2, capacity))
+{
+}
+
+/**
+ * @brief          修改容量：按新容量重排整个池，每条航迹保留最新的点
+ * @param capacity 每条航迹的点数上限（至少 2）
+ */
+void MapTrackPool::setCapacity(int capacity)
+{
+    capacity = qMax(2, capacity);
+    if (capacity == m_capacity)
+        return;
+
+    const int slots = slotCount();
+    QVector<QPointF> points(slots * capacity);
+    for (int s = 0; s < slots; ++s)
+    {
+        const int keep = qMin(m_length[s], capacity);
+        const int skip = m_length[s] - keep;
+        for (int i = 0; i < keep; ++i)
+            points[s * capacity + i] = at(s, skip + i);
+        m_head[s]   = 0;
+        m_length[s] = keep;
+    }
+
+    m_points.swap(points);
+    m_capacity = capacity;
+
+    for (int s = 0; s < slots; ++s)
+    {
+        m_bounds[s]   = boundingRect(s);
+        m_sinceFit[s] = 0;
+    }
+}
+
+void MapTrackPool::ensureSlots(int count)
+{
+    if (count <= slotCount())
+        return;
+
+    m_points.resize(count * m_capacity);
+    m_head.resize(count);
+    m_length.resize(count);
+    m_appended.resize(count);
+    m_bounds.resize(count);
+    m_sinceFit.resize(count);
+}
+
+void MapTrackPool::clear()
+{
+    m_points.clear();
+    m_head.clear();
+    m_length.clear();
+    m_appended.clear();
+    m_bounds.clear();
+    m_sinceFit.clear();
+}
+
+/**
+ * @brief         追加航迹点
+ * @param slot    航迹号（不存在时自动扩充）
+ * @param pt      scene 坐标
+ * @param removed 航迹已满时输出被覆盖的最旧点
+ * @return        覆盖了最旧点返回 true
+ */
+bool MapTrackPool::append(int slot, const QPointF& pt, QPointF* removed)
+{
+    if (slot >= slotCount())
+        ensureSlots(std::max(slot + 1, slotCount() * 2));
+
+    QPointF* ring = m_points.data() + slot * m_capacity;
+    int& head = m_head[slot];
+    int& len  = m_length[slot];
+    ++m_appended[slot];
+
+    QRectF& b = m_bounds[slot];
+    if (len == 0)
+    {
+        b = QRectF(pt, QSizeF(0, 0));
+    }
+    else
+    {
+        b.setLeft(std::min(b.left(), pt.x()));
+        b.setRight(std::max(b.right(), pt.x()));
+        b.setTop(std::min(b.top(), pt.y()));
+        b.setBottom(std::max(b.bottom(), pt.y()));
+    }
+
+    if (len < m_capacity)
+    {
+        ring[(head + len) % m_capacity] = pt;
+        ++len;
+        return false;
+    }
+
+    // 已满：新点写在最旧点的位置，头部后移
+    if (removed)
+        *removed = ring[head];
+    ring[head] = pt;
+    head = (head + 1) % m_capacity;
+
+    // 被覆盖的点不会让包围矩形收缩，整圈覆盖后重算一次（均摊 O(1)）
+    if (++m_sinceFit[slot] >= m_capacity)
+    {
+        b = boundingRect(slot);
+        m_sinceFit[slot] = 0;
+    }
+    return true;
+}
+
+QRectF MapTrackPool::boundingRect(int slot) const
+{
+    const int n = size(slot);
+    if (n == 0)
+        return QRectF();
+
+    double x0 = first(slot).x(), x1 = x0;
+    double y0 = first(slot).y(), y1 = y0;
+    for (int i = 1; i < n; ++i)
+    {
+        const QPointF& p = at(slot, i);
+        x0 = std::min(x0, p.x());
+        x1 = std::max(x1, p.x());
+        y0 = std::min(y0, p.y());
+        y1 = std::max(y1, p.y());
+    }
+    return QRectF(QPointF(x0, y0), QPointF(x1, y1));
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include "mapgraphicsview_global.h"
+#include <QPointF>
+#include <QRectF>
+#include <QVector>
+
+// 航迹池：所有航迹共用一块连续内存，每条航迹是其中固定容量的环形缓冲区，
+// 航迹号（slot）与目标存储下标一致。追加 O(1)，稳定运行后不再分配内存，
+// 超出容量时覆盖最旧的点，不再整体前移。
+class MAPGRAPHICSVIEW_EXPORT MapTrackPool
+{
+public:
+    explicit MapTrackPool(int capacity = 60);
+
+    // 每条航迹最多保留的点数；已有航迹保留最新的点
+    void setCapacity(int capacity);
+    int capacity() const { return m_capacity; }
+
+    int slotCount() const { return m_length.size(); }
+    void ensureSlots(int count);
+    void clear();
+
+    // 追加一点；航迹已满时返回被覆盖的最旧点（removed 可为空）
+    bool append(int slot, const QPointF& pt, QPointF* removed = nullptr);
+
+    int size(int slot) const { return slot < m_length.size() ? m_length[slot] : 0; }
+    // 第 i 个点（0 为最旧）
+    const QPointF& at(int slot, int i) const
+    {
+        return m_points[slot * m_capacity + (m_head[slot] + i) % m_capacity];
+    }
+    const QPointF& first(int slot) const { return at(slot, 0); }
+    const QPointF& last(int slot) const { return at(slot, m_length[slot] - 1); }
+    QRectF boundingRect(int slot) const;   // 精确包围矩形（O(n)）
+    // 保守包围矩形（O(1)，可能比实际略大，用于裁剪）
+    QRectF bounds(int slot) const { return slot < m_bounds.size() ? m_bounds[slot] : QRectF(); }
+    // 该航迹累计追加过的点数（含已被覆盖的），第 i 个点的序号为 appended - size + i
+    quint64 appended(int slot) const { return slot < m_appended.size() ? m_appended[slot] : 0; }
+
+private:
+    int m_capacity = 60;
+    QVector<QPointF> m_points;   // slotCount * capacity
+    QVector<int> m_head;         // 每条航迹最旧点在环中的位置
+    QVector<int> m_length;       // 每条航迹当前点数
+    QVector<quint64> m_appended; // 每条航迹累计追加点数（供增量简化使用）
+    QVector<QRectF> m_bounds;    // 保守包围矩形：追加时扩大，每覆盖一整圈重算一次
+    QVector<int> m_sinceFit;     // 上次重算后覆盖的点数
+};
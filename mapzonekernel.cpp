@@ -0,0 +1,118 @@
+#include "mapzonekernel.h"
+
+#include <QVarLengthArray>
+#include <algorithm>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define LX_HAVE_AVX 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LX_HAVE_SSE2 1
+#endif
+
+namespace MapZoneKernel
+{
+
+const char* isaName()
+{
+#if defined(LX_HAVE_AVX)
+    return "AVX";
+#elif defined(LX_HAVE_SSE2)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+void circle(const double* xs, const double* ys, int n, double cx, double cy, double r2, quint8* inside)
+{
+    int i = 0;
+#if defined(LX_HAVE_AVX)
+    const __m256d vcx = _mm256_set1_pd(cx), vcy = _mm256_set1_pd(cy), vr2 = _mm256_set1_pd(r2);
+    for (; i + 4 <= n; i += 4)
+    {
+        const __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(xs + i), vcx);
+        const __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(ys + i), vcy);
+        const __m256d d2 = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+        const int mask = _mm256_movemask_pd(_mm256_cmp_pd(d2, vr2, _CMP_LE_OQ));
+        inside[i]     |= quint8(mask & 1);
+        inside[i + 1] |= quint8((mask >> 1) & 1);
+        inside[i + 2] |= quint8((mask >> 2) & 1);
+        inside[i + 3] |= quint8((mask >> 3) & 1);
+    }
+#elif defined(LX_HAVE_SSE2)
+    const __m128d vcx = _mm_set1_pd(cx), vcy = _mm_set1_pd(cy), vr2 = _mm_set1_pd(r2);
+    for (; i + 2 <= n; i += 2)
+    {
+        const __m128d dx = _mm_sub_pd(_mm_loadu_pd(xs + i), vcx);
+        const __m128d dy = _mm_sub_pd(_mm_loadu_pd(ys + i), vcy);
+        const __m128d d2 = _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy));
+        const int mask = _mm_movemask_pd(_mm_cmple_pd(d2, vr2));
+        inside[i]     |= quint8(mask & 1);
+        inside[i + 1] |= quint8((mask >> 1) & 1);
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        const double dx = xs[i] - cx, dy = ys[i] - cy;
+        if (dx * dx + dy * dy <= r2)
+            inside[i] = 1;
+    }
+}
+
+void polygon(const double* xs, const double* ys, int n, const Edge* edges, int edgeCount, quint8* inside)
+{
+    // 奇偶位先累积在临时数组里，最后再或进 inside
+    QVarLengthArray<quint8, 1024> parity(n);
+    std::fill(parity.begin(), parity.end(), quint8(0));
+
+    for (int k = 0; k < edgeCount; ++k)
+    {
+        const Edge& e = edges[k];
+        int i = 0;
+#if defined(LX_HAVE_AVX)
+        const __m256d y0 = _mm256_set1_pd(e.y0), y1 = _mm256_set1_pd(e.y1);
+        const __m256d x0 = _mm256_set1_pd(e.x0), k1 = _mm256_set1_pd(e.dxdy);
+        for (; i + 4 <= n; i += 4)
+        {
+            const __m256d y = _mm256_loadu_pd(ys + i);
+            const __m256d x = _mm256_loadu_pd(xs + i);
+            const __m256d xe = _mm256_add_pd(x0, _mm256_mul_pd(_mm256_sub_pd(y, y0), k1));
+            const __m256d hit = _mm256_and_pd(_mm256_and_pd(_mm256_cmp_pd(y, y0, _CMP_GE_OQ),
+                                                            _mm256_cmp_pd(y, y1, _CMP_LT_OQ)),
+                                              _mm256_cmp_pd(x, xe, _CMP_LT_OQ));
+            const int mask = _mm256_movemask_pd(hit);
+            parity[i]     ^= quint8(mask & 1);
+            parity[i + 1] ^= quint8((mask >> 1) & 1);
+            parity[i + 2] ^= quint8((mask >> 2) & 1);
+            parity[i + 3] ^= quint8((mask >> 3) & 1);
+        }
+#elif defined(LX_HAVE_SSE2)
+        const __m128d y0 = _mm_set1_pd(e.y0), y1 = _mm_set1_pd(e.y1);
+        const __m128d x0 = _mm_set1_pd(e.x0), k1 = _mm_set1_pd(e.dxdy);
+        for (; i + 2 <= n; i += 2)
+        {
+            const __m128d y = _mm_loadu_pd(ys + i);
+            const __m128d x = _mm_loadu_pd(xs + i);
+            const __m128d xe = _mm_add_pd(x0, _mm_mul_pd(_mm_sub_pd(y, y0), k1));
+            const __m128d hit = _mm_and_pd(_mm_and_pd(_mm_cmpge_pd(y, y0), _mm_cmplt_pd(y, y1)),
+                                           _mm_cmplt_pd(x, xe));
+            const int mask = _mm_movemask_pd(hit);
+            parity[i]     ^= quint8(mask & 1);
+            parity[i + 1] ^= quint8((mask >> 1) & 1);
+        }
+#endif
+        for (; i < n; ++i)
+        {
+            if (ys[i] >= e.y0 && ys[i] < e.y1 && xs[i] < e.x0 + (ys[i] - e.y0) * e.dxdy)
+                parity[i] ^= 1;
+        }
+    }
+
+    for (int i = 0; i < n; ++i)
+        inside[i] |= parity[i];
+}
+
+}   // namespace MapZoneKernel
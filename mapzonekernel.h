@@ -0,0 +1,27 @@
+#pragma once
+#include "mapgraphicsview_global.h"
+#include <QtGlobal>
+
+// 批量点-区域判断内核：一次判断一批点（x、y 分开存放的连续数组）是否落在某个警戒区内。
+// 有 AVX 时每次处理 4 个点，SSE2 每次 2 个点，其余平台为标量实现；结果按位或进 inside。
+namespace MapZoneKernel
+{
+// 多边形的一条非水平边（y0 < y1）
+struct Edge
+{
+    double y0 = 0.0, y1 = 0.0;
+    double x0 = 0.0;     // y0 处的 x
+    double dxdy = 0.0;
+};
+
+// 圆：(x-cx)^2 + (y-cy)^2 <= r2 的点置 inside[i] = 1
+MAPGRAPHICSVIEW_EXPORT void circle(const double* xs, const double* ys, int n,
+                                   double cx, double cy, double r2, quint8* inside);
+
+// 多边形（奇偶规则射线法）：按边外层、点内层循环，每条边对所有点并行翻转奇偶位
+MAPGRAPHICSVIEW_EXPORT void polygon(const double* xs, const double* ys, int n,
+                                    const Edge* edges, int edgeCount, quint8* inside);
+
+// 当前编译使用的指令集（"AVX" / "SSE2" / "scalar"）
+MAPGRAPHICSVIEW_EXPORT const char* isaName();
+}